@@ -0,0 +1,77 @@
+#include <iostream>
+#include <random>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshBVH.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+int main()
+{
+    const uint32_t numRays = 1 << 20;
+    const uint32_t numPoints = 1 << 16;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto randomVector = [&]() { return glm::vec3(distribution(random), distribution(random), distribution(random)); };
+
+    // Rays from around the sphere towards random points near it, about half of them hit
+    std::vector<Ray> rays(numRays);
+    for(Ray& ray : rays)
+    {
+        const glm::vec3 origin = 3.0f * glm::normalize(randomVector());
+        ray = Ray(origin, randomVector() - origin);
+    }
+
+    // Points around the surface, the ones close to the center are at the same distance of every triangle
+    std::vector<glm::vec3> points(numPoints);
+    for(glm::vec3& point : points) point = (1.0f + 0.1f * distribution(random)) * glm::normalize(randomVector());
+
+    for(uint32_t subdivisions : {6, 8})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        std::cout << "Isosphere " << subdivisions << ": " << mesh->getIndices().size() / 3 << " triangles" << std::endl;
+
+        MeshBVH bvh;
+        for(uint32_t numThreads : {1u, Parallel::getNumThreads(0)})
+        {
+            Timer timer;
+            timer.start();
+            bvh.build(*mesh, numThreads);
+            std::cout << "\tBuilt with " << numThreads << " threads in " << 1000.0f * timer.getElapsedSeconds() << " ms, "
+                      << bvh.getNodes().size() << " nodes" << std::endl;
+        }
+
+        Timer timer;
+        timer.start();
+        bvh.refit();
+        std::cout << "\tRefit in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+
+        std::vector<RayHit> hits;
+        timer.start();
+        bvh.intersect(rays, hits);
+        float time = timer.getElapsedSeconds();
+        size_t numHits = 0;
+        for(const RayHit& hit : hits) numHits += hit.triangle != ~0u;
+        std::cout << "\tClosest hit: " << 1e-6f * static_cast<float>(numRays) / time << " Mrays/s, "
+                  << 100.0f * static_cast<float>(numHits) / static_cast<float>(numRays) << "% hit" << std::endl;
+
+        timer.start();
+        numHits = 0;
+        for(const Ray& ray : rays) numHits += bvh.intersectAny(ray);
+        time = timer.getElapsedSeconds();
+        std::cout << "\tAny hit, 1 thread: " << 1e-6f * static_cast<float>(numRays) / time << " Mrays/s" << std::endl;
+
+        timer.start();
+        float sum = 0.0f;
+        for(const glm::vec3& point : points)
+        {
+            NearestPoint nearest;
+            if(bvh.findNearestPoint(point, nearest)) sum += nearest.distance;
+        }
+        time = timer.getElapsedSeconds();
+        std::cout << "\tNearest point, 1 thread: " << 1e-6f * static_cast<float>(numPoints) / time << " Mqueries/s, mean distance "
+                  << sum / static_cast<float>(numPoints) << std::endl;
+    }
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "MyRender/utils/ChunkedMesh.h"
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+constexpr float PI = 3.14159265358979f;
+
+// Flies a camera around the mesh close to its surface and streams the pages near it into a pool of slots,
+// with the same limits StreamedMesh applies on the GPU
+void streamPath(const MappedChunkedMesh& mesh, size_t budgetBytes, uint32_t maxLoadsPerFrame)
+{
+    const size_t vertexSlotBytes = mesh.getMaxPageVertices() * sizeof(ChunkedMeshFile::PageVertex);
+    const size_t indexSlotBytes = mesh.getMaxPageIndices() * sizeof(uint16_t);
+    const uint32_t numSlots = static_cast<uint32_t>(std::max<size_t>(budgetBytes / (vertexSlotBytes + indexSlotBytes), 1));
+    std::vector<uint8_t> vertexPool(numSlots * vertexSlotBytes), indexPool(numSlots * indexSlotBytes);
+    PageCache cache(numSlots, mesh.getNumPages());
+
+    const BoundingBox& bounds = mesh.getBoundingBox();
+    const glm::vec3 center = 0.5f * (bounds.min + bounds.max);
+    const float radius = 0.5f * bounds.getSize().x;
+    const float loadDistance = 0.25f * radius;
+
+    const uint32_t numFrames = 720;
+    size_t numLoads = 0, numEvictions = 0, numMissing = 0, numDrawn = 0, loadedBytes = 0;
+    std::vector<uint32_t> pages;
+    Timer timer;
+    timer.start();
+    for(uint32_t frame = 0; frame < numFrames; frame++)
+    {
+        const float angle = 2.0f * PI * static_cast<float>(frame) / static_cast<float>(numFrames);
+        const glm::vec3 camera = center + 1.1f * radius * glm::vec3(std::cos(angle), 0.3f * std::sin(3.0f * angle), std::sin(angle));
+        mesh.selectPages(camera, loadDistance, pages);
+        cache.nextFrame();
+
+        uint32_t numFrameLoads = 0;
+        for(uint32_t page : pages)
+        {
+            uint32_t slot = cache.find(page);
+            if(slot != PageCache::NONE)
+            {
+                cache.touch(slot);
+                numDrawn++;
+                continue;
+            }
+
+            uint32_t evictedPage;
+            if(numFrameLoads == maxLoadsPerFrame || (slot = cache.acquire(page, evictedPage)) == PageCache::NONE)
+            {
+                numMissing++;
+                continue;
+            }
+            const ChunkedMeshFile::Page& info = mesh.getPage(page);
+            const size_t vertexBytes = info.numVertices * sizeof(ChunkedMeshFile::PageVertex);
+            const size_t indexBytes = info.numIndices * sizeof(uint16_t);
+            std::memcpy(vertexPool.data() + slot * vertexSlotBytes, mesh.getPageVertices(page), vertexBytes);
+            std::memcpy(indexPool.data() + slot * indexSlotBytes, mesh.getPageIndices(page), indexBytes);
+            numEvictions += evictedPage != PageCache::NONE;
+            numFrameLoads++;
+            numLoads++;
+            numDrawn++;
+            loadedBytes += vertexBytes + indexBytes;
+        }
+    }
+    const float time = timer.getElapsedSeconds();
+
+    std::cout << "\tBudget " << budgetBytes / (1 << 20) << " MB, " << numSlots << " slots: " << numLoads << " loads ("
+              << 1e-6f * static_cast<float>(loadedBytes) << " MB), " << numEvictions << " evictions, "
+              << static_cast<float>(numDrawn) / numFrames << " pages drawn and " << static_cast<float>(numMissing) / numFrames
+              << " missing per frame, " << 1000.0f * time / numFrames << " ms per frame" << std::endl;
+}
+
+int main()
+{
+    const std::string path = "chunked_mesh_benchmark.mrchunks";
+
+    for(uint32_t subdivisions : {7, 9})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        const size_t meshBytes = mesh->getVertices().size() * 2 * sizeof(glm::vec3) + mesh->getIndices().size() * sizeof(uint32_t);
+
+        Timer timer;
+        timer.start();
+        ChunkedMeshFile::write(path, *mesh, 1u << 13);
+        const float writeTime = timer.getElapsedSeconds();
+        std::cout << "Isosphere " << subdivisions << ": " << mesh->getIndices().size() / 3 << " triangles, "
+                  << 1e-6f * static_cast<float>(meshBytes) << " MB as a whole mesh, written in " << 1000.0f * writeTime << " ms" << std::endl;
+        mesh.reset();
+
+        MappedChunkedMesh chunked;
+        timer.start();
+        chunked.open(path);
+        std::cout << "\t" << chunked.getNumPages() << " pages of at most " << chunked.getMaxPageVertices() << " vertices, opened in "
+                  << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+
+        for(size_t budget : {4u << 20, 16u << 20, 64u << 20}) streamPath(chunked, budget, 8);
+    }
+
+    std::remove(path.c_str());
+}
@@ -3,6 +3,7 @@
 #include "MyRender/Scene.h"
 #include "MyRender/MainLoop.h"
 #include "MyRender/RenderMesh.h"
+#include "MyRender/PrimitiveCache.h"
 #include "MyRender/utils/PrimitivesFactory.h"
 #include "MyRender/shaders/Shader.h"
 #include "MyRender/NavigationCamera.h"
@@ -17,10 +18,8 @@ int main()
         auto nCamera = s.createSystem<NavigationCamera>();
         nCamera->setDiableMouseOnRotation(false);
         s.setMainCamera(nCamera);
-        auto myCube = PrimitivesFactory::getCube();
-        myCube->computeNormals();
         auto mesh = s.createSystem<RenderMesh>();
-        mesh->setMeshData(*myCube);
+        PrimitiveCache::getInstance()->setMeshData(*mesh, PrimitivesFactory::PrimitiveDesc::cube());
         mesh->setShader(Shader::loadShader("LightRender"));
         std::vector<float> v = { 0.0f };
         mesh->getShader().setBufferData("mydata", v);
@@ -0,0 +1,51 @@
+#include <iostream>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/HalfEdgeMesh.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+int main()
+{
+    for(uint32_t subdivisions : {7, 9})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        const size_t numTriangles = mesh->getIndices().size() / 3;
+        std::cout << "Isosphere " << subdivisions << ": " << numTriangles << " triangles" << std::endl;
+
+        HalfEdgeMesh halfEdges;
+        for(uint32_t numThreads : {1u, Parallel::getNumThreads(0)})
+        {
+            Timer timer;
+            timer.start();
+            halfEdges.build(*mesh, numThreads);
+            std::cout << "\tBuilt with " << numThreads << " threads in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+        }
+
+        const size_t numBytes = sizeof(uint32_t) * (halfEdges.getNumHalfEdges() + halfEdges.getNumVertices());
+        std::cout << "\t" << static_cast<float>(numBytes) / static_cast<float>(numTriangles) << " bytes per triangle, "
+                  << (halfEdges.isClosed() ? "closed" : "open") << ", " << (halfEdges.isManifold() ? "manifold" : "non manifold") << std::endl;
+
+        // Mean of the one ring of every vertex, the access pattern of smoothing
+        Timer timer;
+        timer.start();
+        std::vector<glm::vec3> means(mesh->getVertices().size());
+        Parallel::forRange(0, means.size(), [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; v++)
+            {
+                glm::vec3 sum(0.0f);
+                uint32_t count = 0;
+                halfEdges.forEachNeighbour(static_cast<uint32_t>(v), [&](uint32_t neighbour)
+                {
+                    sum += mesh->getVertices()[neighbour];
+                    count++;
+                });
+                means[v] = count > 0 ? sum / static_cast<float>(count) : mesh->getVertices()[v];
+            }
+        });
+        std::cout << "\tOne ring means in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,48 @@
+#include <cmath>
+#include <iostream>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/IsosurfaceExtractor.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+int main()
+{
+    // Gyroid, a surface that crosses the whole volume
+    for(uint32_t resolution : {256u, 512u})
+    {
+        SdfGrid grid;
+        grid.resolution = glm::uvec3(resolution);
+        grid.voxelSize = 1.0f / static_cast<float>(resolution - 1);
+        grid.values.resize(static_cast<size_t>(resolution) * resolution * resolution);
+        const float frequency = 8.0f * 3.14159265f;
+        Parallel::forRange(0, resolution, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(uint32_t z = static_cast<uint32_t>(begin); z < end; z++)
+            {
+                for(uint32_t y = 0; y < resolution; y++)
+                {
+                    for(uint32_t x = 0; x < resolution; x++)
+                    {
+                        const glm::vec3 p = frequency * grid.getPosition(x, y, z);
+                        grid.values[grid.getIndex(x, y, z)] = std::sin(p.x) * std::cos(p.y) + std::sin(p.y) * std::cos(p.z) +
+                                                              std::sin(p.z) * std::cos(p.x);
+                    }
+                }
+            }
+        }, 0, 1);
+
+        std::cout << "Gyroid " << resolution << "^3:" << std::endl;
+        for(uint32_t numThreads : {1u, Parallel::getNumThreads(0)})
+        {
+            Timer timer;
+            timer.start();
+            std::shared_ptr<Mesh> mesh = IsosurfaceExtractor::extract(grid, 0.0f, numThreads);
+            const float time = timer.getElapsedSeconds();
+            std::cout << "\t" << numThreads << " threads: " << 1000.0f * time << " ms, "
+                      << 1e-6f * static_cast<float>(grid.values.size()) / time << " Mvoxels/s, " << mesh->getVertices().size()
+                      << " vertices, " << mesh->getIndices().size() / 3 << " triangles" << std::endl;
+        }
+    }
+}
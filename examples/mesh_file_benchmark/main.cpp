@@ -0,0 +1,116 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshFile.h"
+#include "MyRender/utils/MeshSimplifier.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+// Baseline: the whole file read into memory with a stream before building the mesh
+Mesh readWithStream(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    std::vector<char> buffer(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+
+    MeshFile::Header header;
+    std::memcpy(&header, buffer.data(), sizeof(MeshFile::Header));
+    std::vector<glm::vec3> vertices, normals;
+    std::vector<uint32_t> indices;
+    const MeshFile::Section* table = reinterpret_cast<const MeshFile::Section*>(buffer.data() + sizeof(MeshFile::Header));
+    for(uint32_t s = 0; s < header.numSections; s++)
+    {
+        const char* data = buffer.data() + table[s].offset;
+        switch(static_cast<MeshFile::SectionType>(table[s].type))
+        {
+            case MeshFile::SectionType::POSITIONS:
+                vertices.resize(table[s].numElements);
+                std::memcpy(vertices.data(), data, vertices.size() * sizeof(glm::vec3));
+                break;
+            case MeshFile::SectionType::NORMALS:
+                normals.resize(table[s].numElements);
+                std::memcpy(normals.data(), data, normals.size() * sizeof(glm::vec3));
+                break;
+            case MeshFile::SectionType::INDICES:
+                indices.resize(table[s].numElements);
+                std::memcpy(indices.data(), data, indices.size() * sizeof(uint32_t));
+                break;
+            default:
+                break;
+        }
+    }
+    Mesh mesh(vertices.data(), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+    mesh.getNormals() = std::move(normals);
+    return mesh;
+}
+
+// Reads every vertex and index as an upload would
+float touchMapping(const MappedMesh& mesh)
+{
+    float sum = 0.0f;
+    for(size_t i = 0; i < mesh.getNumVertices(); i++) sum += mesh.getVertices()[i].x;
+    for(size_t i = 0; i < mesh.getNumAllIndices(); i++) sum += static_cast<float>(mesh.getAllIndices()[i] & 1);
+    return sum;
+}
+
+int main()
+{
+    const uint32_t numIterations = 10;
+    const std::string path = "mesh_file_benchmark.mrmesh";
+
+    for(uint32_t subdivisions : {6, 8})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        const std::vector<MeshSimplifier::MeshLod> lods = MeshSimplifier::buildLodChain(*mesh);
+
+        Timer timer;
+        timer.start();
+        MeshFile::write(path, *mesh, lods);
+        const float writeTime = timer.getElapsedSeconds();
+
+        MappedMesh mapped;
+        mapped.open(path);
+        const float fileMB = 1e-6f * static_cast<float>(mapped.getNumVertices() * 2 * sizeof(glm::vec3) + mapped.getNumAllIndices() * sizeof(uint32_t));
+        mapped.close();
+
+        std::cout << "Isosphere " << subdivisions << ": " << mesh->getIndices().size() / 3 << " triangles, "
+                  << lods.size() << " lods, " << fileMB << " MB, written in " << 1000.0f * writeTime << " ms" << std::endl;
+
+        // The file stays in the page cache after the first read, so this measures the load path and not the disk
+        float checksum = 0.0f;
+        timer.start();
+        for(uint32_t i = 0; i < numIterations; i++)
+        {
+            MappedMesh file;
+            file.open(path);
+            checksum += touchMapping(file);
+        }
+        float time = timer.getElapsedSeconds() / static_cast<float>(numIterations);
+        std::cout << "\tMapped and read: " << 1000.0f * time << " ms, " << fileMB / time << " MB/s" << std::endl;
+
+        timer.start();
+        for(uint32_t i = 0; i < numIterations; i++)
+        {
+            MappedMesh file;
+            file.open(path);
+            checksum += static_cast<float>(file.toMesh().getIndices().size());
+        }
+        time = timer.getElapsedSeconds() / static_cast<float>(numIterations);
+        std::cout << "\tMapped to Mesh: " << 1000.0f * time << " ms, " << fileMB / time << " MB/s" << std::endl;
+
+        timer.start();
+        for(uint32_t i = 0; i < numIterations; i++) checksum += static_cast<float>(readWithStream(path).getIndices().size());
+        time = timer.getElapsedSeconds() / static_cast<float>(numIterations);
+        std::cout << "\tStream to Mesh: " << 1000.0f * time << " ms, " << fileMB / time << " MB/s" << std::endl;
+
+        if(checksum == 0.0f) std::cout << std::endl;
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshLoader.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+// Writes the mesh as an OBJ with a normal per vertex. Returns the file size
+size_t writeObj(const std::string& path, const Mesh& mesh, bool splitNormals)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if(file == nullptr) return 0;
+
+    for(const glm::vec3& v : mesh.getVertices()) std::fprintf(file, "v %.6f %.6f %.6f\n", v.x, v.y, v.z);
+    for(const glm::vec3& n : mesh.getNormals()) std::fprintf(file, "vn %.6f %.6f %.6f\n", n.x, n.y, n.z);
+
+    // Shifted normal indices differ from the position ones, so the loader has to merge the pairs
+    const std::vector<uint32_t>& indices = mesh.getIndices();
+    const size_t numVertices = mesh.getVertices().size();
+    for(size_t i = 0; i < indices.size(); i += 3)
+    {
+        const size_t shift = splitNormals ? 1 : 0;
+        std::fprintf(file, "f %u//%u %u//%u %u//%u\n",
+                     indices[i] + 1, static_cast<uint32_t>((indices[i] + shift) % numVertices) + 1,
+                     indices[i + 1] + 1, static_cast<uint32_t>((indices[i + 1] + shift) % numVertices) + 1,
+                     indices[i + 2] + 1, static_cast<uint32_t>((indices[i + 2] + shift) % numVertices) + 1);
+    }
+
+    const size_t size = static_cast<size_t>(std::ftell(file));
+    std::fclose(file);
+    return size;
+}
+
+// Binary little endian PLY with positions, normals and triangles
+size_t writePly(const std::string& path, const Mesh& mesh)
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr) return 0;
+
+    const std::vector<glm::vec3>& vertices = mesh.getVertices();
+    const std::vector<glm::vec3>& normals = mesh.getNormals();
+    const std::vector<uint32_t>& indices = mesh.getIndices();
+    std::fprintf(file, "ply\nformat binary_little_endian 1.0\nelement vertex %zu\n"
+                       "property float x\nproperty float y\nproperty float z\nproperty float nx\nproperty float ny\nproperty float nz\n"
+                       "element face %zu\nproperty list uchar int vertex_indices\nend_header\n", vertices.size(), indices.size() / 3);
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        std::fwrite(&vertices[i], sizeof(glm::vec3), 1, file);
+        std::fwrite(&normals[i], sizeof(glm::vec3), 1, file);
+    }
+    const uint8_t count = 3;
+    for(size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::fwrite(&count, 1, 1, file);
+        std::fwrite(&indices[i], sizeof(uint32_t), 3, file);
+    }
+
+    const size_t size = static_cast<size_t>(std::ftell(file));
+    std::fclose(file);
+    return size;
+}
+
+// Binary STL, the facet normals are left as zero
+size_t writeStl(const std::string& path, const Mesh& mesh)
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr) return 0;
+
+    const std::vector<glm::vec3>& vertices = mesh.getVertices();
+    const std::vector<uint32_t>& indices = mesh.getIndices();
+    const char header[80] = {};
+    const uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+    std::fwrite(header, 1, sizeof(header), file);
+    std::fwrite(&numTriangles, sizeof(uint32_t), 1, file);
+    const glm::vec3 normal(0.0f);
+    const uint16_t attribute = 0;
+    for(size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::fwrite(&normal, sizeof(glm::vec3), 1, file);
+        for(size_t k = 0; k < 3; k++) std::fwrite(&vertices[indices[i + k]], sizeof(glm::vec3), 1, file);
+        std::fwrite(&attribute, sizeof(uint16_t), 1, file);
+    }
+
+    const size_t size = static_cast<size_t>(std::ftell(file));
+    std::fclose(file);
+    return size;
+}
+
+template<typename F>
+void benchmarkLoad(const std::string& name, size_t fileSize, F&& load)
+{
+    const float fileMB = 1e-6f * static_cast<float>(fileSize);
+
+    // The first load brings the file to the page cache
+    std::shared_ptr<Mesh> loaded = load(0u);
+    if(loaded == nullptr) return;
+    std::cout << name << ": " << fileMB << " MB, " << loaded->getVertices().size() << " vertices, "
+              << loaded->getIndices().size() / 3 << " triangles" << std::endl;
+
+    for(uint32_t numThreads : {1u, Parallel::getNumThreads(0)})
+    {
+        Timer timer;
+        timer.start();
+        loaded = load(numThreads);
+        const float time = timer.getElapsedSeconds();
+        std::cout << "\t" << numThreads << " threads: " << 1000.0f * time << " ms, " << fileMB / time << " MB/s" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // 8 subdivisions writes about 150 MB of OBJ, 10 more than 2 GB
+    const uint32_t subdivisions = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 8;
+    const std::string path = "mesh_loader_benchmark";
+
+    std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+    mesh->computeNormals();
+    std::cout << "Isosphere " << subdivisions << ": " << mesh->getIndices().size() / 3 << " triangles" << std::endl;
+
+    for(bool splitNormals : {false, true})
+    {
+        const size_t fileSize = writeObj(path + ".obj", *mesh, splitNormals);
+        benchmarkLoad(splitNormals ? "OBJ with shifted normals" : "OBJ", fileSize, [&](uint32_t numThreads)
+        {
+            return MeshLoader::loadObj(path + ".obj", true, numThreads);
+        });
+    }
+    std::remove((path + ".obj").c_str());
+
+    benchmarkLoad("PLY", writePly(path + ".ply", *mesh), [&](uint32_t numThreads)
+    {
+        return MeshLoader::loadPly(path + ".ply", nullptr, numThreads);
+    });
+    std::remove((path + ".ply").c_str());
+
+    const size_t stlSize = writeStl(path + ".stl", *mesh);
+    benchmarkLoad("STL", stlSize, [&](uint32_t numThreads)
+    {
+        return MeshLoader::loadStl(path + ".stl", false, 0.0f, nullptr, numThreads);
+    });
+    benchmarkLoad("STL welded", stlSize, [&](uint32_t numThreads)
+    {
+        return MeshLoader::loadStl(path + ".stl", true, 0.0f, nullptr, numThreads);
+    });
+    std::remove((path + ".stl").c_str());
+}
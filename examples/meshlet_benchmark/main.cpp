@@ -0,0 +1,71 @@
+#include <iostream>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshletBuilder.h"
+#include "MyRender/utils/MeshOptimizer.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+void printStatistics(const MeshletBuilder::MeshletData& data)
+{
+    size_t numCullable = 0;
+    for(const MeshletBuilder::MeshletBounds& bounds : data.bounds)
+    {
+        if(bounds.coneCutoff < 1.0f) numCullable++;
+    }
+
+    std::cout << "\t" << data.meshlets.size() << " meshlets, "
+              << static_cast<float>(data.vertices.size()) / static_cast<float>(data.meshlets.size()) << " vertices and "
+              << static_cast<float>(data.triangles.size()) / static_cast<float>(data.meshlets.size()) << " triangles per meshlet, "
+              << 100.0f * static_cast<float>(numCullable) / static_cast<float>(data.meshlets.size()) << "% with a cone" << std::endl;
+}
+
+int main()
+{
+    const uint32_t numIterations = 5;
+
+    for(uint32_t subdivisions : {5, 7, 8})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        MeshOptimizer::optimizeVertexCache(*mesh);
+        const float mTriangles = 1e-6f * static_cast<float>(mesh->getIndices().size() / 3);
+        std::cout << "Isosphere " << subdivisions << ": " << mesh->getIndices().size() / 3 << " triangles" << std::endl;
+
+        MeshletBuilder::MeshletData data;
+        Timer timer;
+        timer.start();
+        for(uint32_t i = 0; i < numIterations; i++) data = MeshletBuilder::buildMeshlets(*mesh);
+        const float time = timer.getElapsedSeconds() / static_cast<float>(numIterations);
+
+        printStatistics(data);
+        std::cout << "\tBuilt in " << 1000.0f * time << " ms, " << 1000.0f * time / mTriangles << " ms per million triangles" << std::endl;
+    }
+
+    // Many small meshes, built in parallel across the meshes
+    const uint32_t numMeshes = 64;
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    std::vector<const Mesh*> meshPointers;
+    size_t numTriangles = 0;
+    for(uint32_t m = 0; m < numMeshes; m++)
+    {
+        meshes.push_back(PrimitivesFactory::getIsosphere(5));
+        MeshOptimizer::optimizeVertexCache(*meshes.back());
+        meshPointers.push_back(meshes.back().get());
+        numTriangles += meshes.back()->getIndices().size() / 3;
+    }
+    const float mTriangles = 1e-6f * static_cast<float>(numTriangles);
+
+    std::cout << numMeshes << " isospheres 5: " << numTriangles << " triangles" << std::endl;
+    for(uint32_t numThreads : {1u, Parallel::getNumThreads(0)})
+    {
+        Timer timer;
+        timer.start();
+        for(uint32_t i = 0; i < numIterations; i++) MeshletBuilder::buildMeshlets(meshPointers, MeshletBuilder::MAX_VERTICES,
+                                                                                  MeshletBuilder::MAX_TRIANGLES, numThreads);
+        const float time = timer.getElapsedSeconds() / static_cast<float>(numIterations);
+        std::cout << "\t" << numThreads << " threads: " << 1000.0f * time << " ms, "
+                  << 1000.0f * time / mTriangles << " ms per million triangles" << std::endl;
+    }
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshBVH.h"
+#include "MyRender/utils/MeshOptimizer.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/SdfBaker.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+// Times the CPU passes that walk the mesh through its indices
+void runPasses(Mesh& mesh, uint32_t sdfResolution)
+{
+    Timer timer;
+    timer.start();
+    mesh.computeNormals();
+    std::cout << "\t\tcomputeNormals in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+
+    timer.start();
+    MeshBVH bvh(mesh);
+    std::cout << "\t\tBVH build in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+
+    timer.start();
+    bvh.refit();
+    std::cout << "\t\tBVH refit in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+
+    timer.start();
+    SdfBaker::bake(mesh, sdfResolution);
+    std::cout << "\t\tSDF bake at " << sdfResolution << "^3 in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+}
+
+int main()
+{
+    std::mt19937 random(7);
+    for(uint32_t subdivisions : {6, 9})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        std::cout << "Isosphere " << subdivisions << ": " << mesh->getIndices().size() / 3 << " triangles" << std::endl;
+
+        // Arbitrary order, as meshes coming from reconstructions or concatenated files usually are
+        std::vector<uint32_t> remap(mesh->getVertices().size());
+        std::iota(remap.begin(), remap.end(), 0);
+        std::shuffle(remap.begin(), remap.end(), random);
+        MeshOptimizer::remapVertexAttribute(mesh->getVertices(), remap);
+        MeshOptimizer::remapIndices(mesh->getIndices(), remap);
+        std::vector<uint32_t> triangles(mesh->getIndices().size() / 3);
+        std::iota(triangles.begin(), triangles.end(), 0);
+        std::shuffle(triangles.begin(), triangles.end(), random);
+        std::vector<uint32_t> shuffledIndices(mesh->getIndices().size());
+        for(size_t t = 0; t < triangles.size(); t++)
+        {
+            std::copy_n(mesh->getIndices().begin() + 3 * triangles[t], 3, shuffledIndices.begin() + 3 * t);
+        }
+        mesh->getIndices().swap(shuffledIndices);
+        mesh->computeBoundingBox();
+
+        const uint32_t sdfResolution = subdivisions < 8 ? 64 : 16;
+        std::cout << "\tShuffled" << std::endl;
+        runPasses(*mesh, sdfResolution);
+
+        Timer timer;
+        timer.start();
+        MeshOptimizer::optimizeSpatialOrder(*mesh);
+        std::cout << "\tMorton order in " << 1000.0f * timer.getElapsedSeconds() << " ms" << std::endl;
+        runPasses(*mesh, sdfResolution);
+    }
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <vector>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+// Previous single threaded implementation, scattering every corner into the vertex normals
+void computeNormalsReference(const Mesh& mesh, std::vector<glm::vec3>& normals)
+{
+    const std::vector<glm::vec3>& vertices = mesh.getVertices();
+    const std::vector<uint32_t>& indices = mesh.getIndices();
+    normals.assign(vertices.size(), glm::vec3(0.0f));
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const glm::vec3 v1 = vertices[indices[i]];
+        const glm::vec3 v2 = vertices[indices[i + 1]];
+        const glm::vec3 v3 = vertices[indices[i + 2]];
+        const glm::vec3 normal = glm::normalize(glm::cross(v2 - v1, v3 - v1));
+
+        normals[indices[i]] += glm::acos(glm::dot(glm::normalize(v2 - v1), glm::normalize(v3 - v1))) * normal;
+        normals[indices[i + 1]] += glm::acos(glm::dot(glm::normalize(v1 - v2), glm::normalize(v3 - v2))) * normal;
+        normals[indices[i + 2]] += glm::acos(glm::dot(glm::normalize(v1 - v3), glm::normalize(v2 - v3))) * normal;
+    }
+
+    for(glm::vec3& n : normals)
+    {
+        n = glm::normalize(n);
+    }
+}
+
+int main()
+{
+    const uint32_t numRepetitions = 5;
+    const uint32_t maxThreads = Parallel::getNumThreads();
+
+    for(uint32_t subdivisions : {6, 7, 8, 9})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        const double numTriangles = static_cast<double>(mesh->getIndices().size() / 3);
+        std::cout << "Isosphere " << subdivisions << ": " << mesh->getIndices().size() / 3 << " triangles" << std::endl;
+
+        Timer timer;
+        std::vector<glm::vec3> refNormals;
+        timer.start();
+        for(uint32_t r = 0; r < numRepetitions; r++) computeNormalsReference(*mesh, refNormals);
+        const float refTime = timer.getElapsedSeconds() / numRepetitions;
+        std::cout << "\tReference: " << numTriangles / refTime * 1e-6 << " Mtris/s" << std::endl;
+
+        for(uint32_t threads = 1; threads <= maxThreads; threads = (threads == maxThreads) ? threads + 1 : std::min(2 * threads, maxThreads))
+        {
+            timer.start();
+            for(uint32_t r = 0; r < numRepetitions; r++) mesh->computeNormals(threads);
+            const float time = timer.getElapsedSeconds() / numRepetitions;
+
+            float maxError = 0.0f;
+            for(size_t v = 0; v < refNormals.size(); v++)
+            {
+                maxError = glm::max(maxError, glm::length(mesh->getNormals()[v] - refNormals[v]));
+            }
+
+            std::cout << "\t" << threads << " threads: " << numTriangles / time * 1e-6 << " Mtris/s"
+                      << " (x" << refTime / time << ", max error " << maxError << ")" << std::endl;
+        }
+    }
+}
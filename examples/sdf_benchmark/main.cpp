@@ -0,0 +1,46 @@
+#include <iostream>
+#include <string>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/SdfBaker.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+int main(int argc, char** argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "sdf_benchmark.mrsdf";
+    std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(4);
+    std::cout << "Isosphere 4: " << mesh->getIndices().size() / 3 << " triangles, "
+              << Parallel::getNumThreads(0) << " threads" << std::endl;
+
+    const std::pair<SdfBaker::SignMethod, const char*> methods[] = {
+        {SdfBaker::SignMethod::WINDING_NUMBER, "winding number"},
+        {SdfBaker::SignMethod::RAY_PARITY, "ray parity"}
+    };
+
+    for(uint32_t resolution : {128u, 512u})
+    {
+        for(const auto& method : methods)
+        {
+            Timer timer;
+            timer.start();
+            SdfGrid grid = SdfBaker::bake(*mesh, resolution, 0.05f, method.first);
+            const float time = timer.getElapsedSeconds();
+            std::cout << resolution << "^3, " << method.second << ": " << time << " s, "
+                      << 1e-6f * static_cast<float>(grid.values.size()) / time << " Mvoxels/s" << std::endl;
+
+            if(method.first != SdfBaker::SignMethod::RAY_PARITY) continue;
+            timer.start();
+            if(!SdfBaker::write(path, grid)) return 1;
+            const float writeTime = timer.getElapsedSeconds();
+            timer.start();
+            SdfGrid loaded;
+            if(!SdfBaker::read(path, loaded)) return 1;
+            const float readTime = timer.getElapsedSeconds();
+            const float megabytes = static_cast<float>(grid.values.size() * sizeof(float)) / (1024.0f * 1024.0f);
+            std::cout << "\tWritten at " << megabytes / writeTime << " MB/s, read at " << megabytes / readTime << " MB/s" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+// Resident memory of the process, only available on Linux
+float getResidentMB()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0, resident = 0;
+    statm >> size >> resident;
+    return 4096e-6f * static_cast<float>(resident);
+#else
+    return 0.0f;
+#endif
+}
+
+// Bytes of the distinct arrays used by the meshes
+template<typename T>
+void addArrayBytes(const std::vector<T>& array, std::set<const void*>& seen, size_t& bytes)
+{
+    if(array.empty() || !seen.insert(array.data()).second) return;
+    bytes += array.size() * sizeof(T);
+}
+
+float getArraysMB(const std::vector<Mesh>& meshes)
+{
+    std::set<const void*> seen;
+    size_t bytes = 0;
+    for(const Mesh& mesh : meshes)
+    {
+        addArrayBytes(mesh.getVertices(), seen, bytes);
+        addArrayBytes(mesh.getIndices(), seen, bytes);
+        addArrayBytes(mesh.getNormals(), seen, bytes);
+    }
+    return 1e-6f * static_cast<float>(bytes);
+}
+
+void report(const std::string& name, const std::vector<Mesh>& meshes, float time, float baseResidentMB)
+{
+    std::cout << "\t" << name << ": " << getArraysMB(meshes) << " MB of arrays, " << getResidentMB() - baseResidentMB
+              << " MB resident, in " << 1000.0f * time << " ms" << std::endl;
+}
+
+int main()
+{
+    const uint32_t numInstances = 16;
+
+    std::shared_ptr<Mesh> source = PrimitivesFactory::getIsosphere(8);
+    source->computeNormals();
+    source->computeBoundingBox();
+    const Mesh& mesh = *source;
+    std::cout << "Isosphere 8: " << mesh.getIndices().size() / 3 << " triangles, " << numInstances << " instances" << std::endl;
+    const float baseResidentMB = getResidentMB();
+
+    Timer timer;
+    {
+        // What every copy cost before the arrays were shared
+        std::vector<Mesh> instances(numInstances);
+        timer.start();
+        for(Mesh& instance : instances)
+        {
+            instance.getVertices() = mesh.getVertices();
+            instance.getIndices() = mesh.getIndices();
+            instance.getNormals() = mesh.getNormals();
+        }
+        report("Deep copies", instances, timer.getElapsedSeconds(), baseResidentMB);
+    }
+
+    {
+        timer.start();
+        std::vector<Mesh> instances(numInstances, mesh);
+        report("Shared copies", instances, timer.getElapsedSeconds(), baseResidentMB);
+
+        // Baking a transform in each instance only duplicates its vertices
+        timer.start();
+        for(uint32_t i = 0; i < numInstances; i++)
+        {
+            instances[i].applyTransform(glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i), 0.0f, 0.0f)));
+        }
+        report("Shared copies transformed", instances, timer.getElapsedSeconds(), baseResidentMB);
+
+        // As RenderMesh does after the upload when setReleaseMeshData is enabled
+        timer.start();
+        for(Mesh& instance : instances) instance.releaseData();
+        report("Released after upload", instances, timer.getElapsedSeconds(), baseResidentMB);
+    }
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/SparseSdf.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+int main(int argc, char** argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "sparse_sdf_benchmark.mrssdf";
+    std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(4);
+
+    float area = 0.0f;
+    const std::vector<glm::vec3>& vertices = mesh->getVertices();
+    const std::vector<uint32_t>& indices = mesh->getIndices();
+    for(size_t i = 0; i < indices.size(); i += 3)
+    {
+        area += 0.5f * glm::length(glm::cross(vertices[indices[i + 1]] - vertices[indices[i]], vertices[indices[i + 2]] - vertices[indices[i]]));
+    }
+    std::cout << "Isosphere 4: " << indices.size() / 3 << " triangles, surface area " << area << std::endl;
+
+    const uint32_t numSamples = 1 << 20;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(-1.2f, 1.2f);
+    std::vector<glm::vec3> points(numSamples);
+    for(glm::vec3& point : points) point = glm::vec3(distribution(random), distribution(random), distribution(random));
+
+    for(uint32_t resolution : {128u, 512u})
+    {
+        SparseSdf sdf;
+        Timer timer;
+        timer.start();
+        sdf.build(*mesh, resolution);
+        const float buildTime = timer.getElapsedSeconds();
+
+        const glm::uvec3 numCells = sdf.getNumCells();
+        const glm::vec3 denseSamples = static_cast<float>(SparseSdf::BRICK_SIZE - 1) * glm::vec3(numCells) + glm::vec3(1.0f);
+        const float denseBytes = sizeof(float) * denseSamples.x * denseSamples.y * denseSamples.z;
+        const float bytes = static_cast<float>(sdf.getMemorySize());
+        const float voxelArea = area / (sdf.getVoxelSize() * sdf.getVoxelSize());
+        std::cout << resolution << "^3: built in " << buildTime << " s, " << sdf.getNumBricks() << " bricks in "
+                  << numCells.x * numCells.y * numCells.z << " cells" << std::endl;
+        std::cout << "\t" << bytes / (1024.0f * 1024.0f) << " MB, " << 100.0f * bytes / denseBytes << "% of the dense grid, "
+                  << bytes / voxelArea << " bytes per voxel of surface area" << std::endl;
+
+        timer.start();
+        float sum = 0.0f;
+        for(const glm::vec3& point : points) sum += sdf.sample(point);
+        const float sampleTime = timer.getElapsedSeconds();
+        std::cout << "\tSampled at " << 1e-6f * static_cast<float>(numSamples) / sampleTime << " Msamples/s, mean " << sum / numSamples << std::endl;
+
+        timer.start();
+        if(!sdf.write(path)) return 1;
+        const float writeTime = timer.getElapsedSeconds();
+        timer.start();
+        SparseSdf loaded;
+        if(!loaded.read(path)) return 1;
+        const float readTime = timer.getElapsedSeconds();
+        std::cout << "\tWritten in " << 1000.0f * writeTime << " ms, read in " << 1000.0f * readTime << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <cmath>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+int main()
+{
+    for(uint32_t subdivisions : {8, 10})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        mesh->computeNormals();
+        // Longitude and latitude, which have a seam but a well defined frame everywhere else
+        std::vector<glm::vec2>& texCoords = mesh->getTexCoords();
+        texCoords.resize(mesh->getVertices().size());
+        for(size_t v = 0; v < texCoords.size(); v++)
+        {
+            const glm::vec3& p = mesh->getVertices()[v];
+            texCoords[v] = glm::vec2(std::atan2(p.z, p.x), std::asin(glm::clamp(p.y, -1.0f, 1.0f)));
+        }
+        std::cout << "Isosphere " << subdivisions << ": " << mesh->getVertices().size() << " vertices, "
+                  << mesh->getIndices().size() / 3 << " triangles" << std::endl;
+
+        for(uint32_t numThreads : {1u, Parallel::getNumThreads(0)})
+        {
+            Timer timer;
+            timer.start();
+            mesh->computeTangents(numThreads);
+            const float time = timer.getElapsedSeconds();
+            std::cout << "\tTangents with " << numThreads << " threads in " << 1000.0f * time << " ms, "
+                      << 1e-6f * static_cast<float>(mesh->getVertices().size()) / time << " Mvertices/s" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshSoA.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/Simd.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+// Previous implementation: one pass for the transformation and another one for the bounding box
+BoundingBox applyTransformReference(std::vector<glm::vec3>& vertices, const glm::mat4& trans)
+{
+    for(glm::vec3& vert : vertices)
+    {
+        vert = glm::vec3(trans * glm::vec4(vert, 1.0));
+    }
+
+    glm::vec3 min(INFINITY);
+    glm::vec3 max(-INFINITY);
+    for(glm::vec3& vert : vertices)
+    {
+        min.x = glm::min(min.x, vert.x);
+        max.x = glm::max(max.x, vert.x);
+
+        min.y = glm::min(min.y, vert.y);
+        max.y = glm::max(max.y, vert.y);
+
+        min.z = glm::min(min.z, vert.z);
+        max.z = glm::max(max.z, vert.z);
+    }
+    return BoundingBox(min, max);
+}
+
+int main()
+{
+    const uint32_t numRepetitions = 10;
+    const glm::mat4 trans = glm::translate(glm::rotate(glm::mat4(1.0f), 0.01f, glm::vec3(0.3f, 1.0f, 0.2f)),
+                                           glm::vec3(0.001f, -0.002f, 0.0f));
+
+    std::vector<uint32_t> threadCounts = {1};
+    if(Parallel::getNumThreads() > 1) threadCounts.push_back(Parallel::getNumThreads());
+
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    for(size_t numVertices : {size_t(1) << 16, size_t(1) << 20, size_t(1) << 24})
+    {
+        Mesh mesh;
+        mesh.getVertices().resize(numVertices);
+        for(glm::vec3& v : mesh.getVertices()) v = glm::vec3(dist(gen), dist(gen), dist(gen));
+        const std::vector<glm::vec3> original = mesh.getVertices();
+        const double gigaBytes = 1e-9 * static_cast<double>(numVertices * sizeof(glm::vec3));
+        std::cout << numVertices << " vertices" << std::endl;
+
+        // Reference
+        std::vector<glm::vec3> refVertices = original;
+        Timer timer;
+        timer.start();
+        BoundingBox refBox;
+        for(uint32_t r = 0; r < numRepetitions; r++) refBox = applyTransformReference(refVertices, trans);
+        const float refTime = timer.getElapsedSeconds() / numRepetitions;
+        std::cout << "\tReference transform: " << 2.0 * gigaBytes / refTime << " GB/s" << std::endl;
+
+        refVertices = original;
+        refBox = applyTransformReference(refVertices, trans);
+
+        for(Simd::Level level : {Simd::Level::SCALAR, Simd::Level::SSE, Simd::Level::AVX2})
+        {
+            if(static_cast<int>(level) > static_cast<int>(Simd::getSupportedLevel())) continue;
+            Simd::setLevel(level);
+
+            for(uint32_t threads : threadCounts)
+            {
+                mesh.getVertices() = original;
+                timer.start();
+                for(uint32_t r = 0; r < numRepetitions; r++) mesh.computeBoundingBox(threads);
+                const float boundsTime = timer.getElapsedSeconds() / numRepetitions;
+
+                timer.start();
+                for(uint32_t r = 0; r < numRepetitions; r++) mesh.applyTransform(trans, threads);
+                const float transformTime = timer.getElapsedSeconds() / numRepetitions;
+
+                // Check a single transformation against the reference
+                mesh.getVertices() = original;
+                mesh.applyTransform(trans, threads);
+                float maxError = glm::max(glm::length(mesh.getBoundingBox().min - refBox.min),
+                                          glm::length(mesh.getBoundingBox().max - refBox.max));
+                for(size_t v = 0; v < numVertices; v++)
+                {
+                    maxError = glm::max(maxError, glm::length(mesh.getVertices()[v] - refVertices[v]));
+                }
+
+                std::cout << "\t" << Simd::getLevelName(level) << ", " << threads << " threads: "
+                          << "bounds " << gigaBytes / boundsTime << " GB/s, "
+                          << "transform " << 2.0 * gigaBytes / transformTime << " GB/s "
+                          << "(x" << refTime / transformTime << ", max error " << maxError << ")" << std::endl;
+            }
+        }
+        Simd::setLevel(Simd::getSupportedLevel());
+
+        // Structure of arrays layout
+        mesh.getVertices() = original;
+        MeshSoA meshSoA(mesh);
+        for(uint32_t threads : threadCounts)
+        {
+            timer.start();
+            for(uint32_t r = 0; r < numRepetitions; r++) meshSoA.computeBoundingBox(threads);
+            const float boundsTime = timer.getElapsedSeconds() / numRepetitions;
+
+            timer.start();
+            for(uint32_t r = 0; r < numRepetitions; r++) meshSoA.applyTransform(trans, threads);
+            const float transformTime = timer.getElapsedSeconds() / numRepetitions;
+
+            std::cout << "\tMeshSoA " << Simd::getLevelName(Simd::getLevel()) << ", " << threads << " threads: "
+                      << "bounds " << gigaBytes / boundsTime << " GB/s, "
+                      << "transform " << 2.0 * gigaBytes / transformTime << " GB/s "
+                      << "(x" << refTime / transformTime << ")" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshOptimizer.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+#include "MyRender/utils/Timer.h"
+
+using namespace myrender;
+
+void printStatistics(const std::string& name, const MeshOptimizer::VertexCacheStatistics& stats)
+{
+    std::cout << "\t" << name << ": ACMR " << stats.acmr << ", ATVR " << stats.atvr
+              << ", " << stats.vertexShaderInvocations << " vertex shader invocations" << std::endl;
+}
+
+void runBenchmark(const std::string& name, Mesh& mesh)
+{
+    std::cout << name << ": " << mesh.getIndices().size() / 3 << " triangles, "
+              << mesh.getVertices().size() << " vertices" << std::endl;
+
+    const MeshOptimizer::VertexCacheStatistics before = MeshOptimizer::analyzeVertexCache(mesh);
+    printStatistics("Before", before);
+
+    Timer timer;
+    timer.start();
+    MeshOptimizer::optimizeVertexCache(mesh);
+    const float time = timer.getElapsedSeconds();
+
+    const MeshOptimizer::VertexCacheStatistics after = MeshOptimizer::analyzeVertexCache(mesh);
+    printStatistics("After", after);
+    std::cout << "\tInvocations reduced by " 
+              << 100.0f * (1.0f - static_cast<float>(after.vertexShaderInvocations) / static_cast<float>(before.vertexShaderInvocations))
+              << "%, optimized in " << 1000.0f * time << " ms ("
+              << 1e-6f * static_cast<float>(mesh.getIndices().size() / 3) / time << " Mtris/s)" << std::endl;
+
+    // Each buffer uploaded by RenderMesh::setMeshData holds one vec3 per vertex
+    const size_t vertexSize = sizeof(glm::vec3);
+    std::cout << "\tVertex fetch overfetch: " 
+              << MeshOptimizer::analyzeVertexFetch(mesh.getIndices(), mesh.getVertices().size(), vertexSize);
+
+    timer.start();
+    MeshOptimizer::optimizeVertexFetch(mesh);
+    const float fetchTime = timer.getElapsedSeconds();
+
+    std::cout << " -> " << MeshOptimizer::analyzeVertexFetch(mesh.getIndices(), mesh.getVertices().size(), vertexSize)
+              << ", reordered in " << 1000.0f * fetchTime << " ms ("
+              << 1e-6f * static_cast<float>(mesh.getVertices().size()) / fetchTime << " Mverts/s)" << std::endl;
+}
+
+int main()
+{
+    for(uint32_t subdivisions : {3, 5, 7, 8})
+    {
+        std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(subdivisions);
+        runBenchmark("Isosphere " + std::to_string(subdivisions), *mesh);
+    }
+
+    // Triangles in random order, like a badly exported asset
+    std::shared_ptr<Mesh> mesh = PrimitivesFactory::getIsosphere(7);
+    std::vector<uint32_t>& indices = mesh->getIndices();
+    std::vector<uint32_t> order(indices.size() / 3);
+    for(uint32_t t = 0; t < order.size(); t++) order[t] = t;
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    std::vector<uint32_t> shuffled(indices.size());
+    for(size_t t = 0; t < order.size(); t++)
+    {
+        for(uint32_t k = 0; k < 3; k++) shuffled[3 * t + k] = indices[3 * order[t] + k];
+    }
+    indices = shuffled;
+    runBenchmark("Shuffled isosphere 7", *mesh);
+}
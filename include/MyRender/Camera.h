@@ -32,6 +32,10 @@ public:
     const glm::mat4x4& getProjectionMatrix() const { return mProjectionMatrix; }
     const glm::mat4x4& getViewMatrix() const { return mViewMatrix; }
     const glm::mat4x4& getInverseViewMatrix() const { return mInverseViewMatrix; }
+
+    // World space direction of the ray from the camera position through a point of the window in pixels,
+    // e.g. the mouse position for picking with MeshBVH::intersect
+    glm::vec3 getRayDirection(glm::vec2 screenPosition) const;
     
     virtual void resize(glm::ivec2 windowSize);
     void drawGui() override;
@@ -0,0 +1,44 @@
+#ifndef PRIMITIVE_CACHE_H
+#define PRIMITIVE_CACHE_H
+
+#include <map>
+#include <memory>
+#include <utility>
+#include "MyRender/RenderMesh.h"
+#include "MyRender/utils/PrimitivesFactory.h"
+
+namespace myrender
+{
+
+// Primitives created once per generator parameters. The CPU mesh is shared by all the callers and the GPU
+// buffers by all the RenderMesh drawing it. Both are released when the last user drops them
+class PrimitiveCache
+{
+public:
+	static PrimitiveCache* getInstance()
+	{
+		if(instance == nullptr)
+		{
+			instance = std::make_unique<PrimitiveCache>();
+		}
+		return instance.get();
+	}
+
+	// The mesh has its normals and its bounding box computed. Copies of it share its arrays until they are
+	// modified, so a copy to transform only duplicates the vertices
+	std::shared_ptr<const Mesh> getMesh(const PrimitivesFactory::PrimitiveDesc& desc);
+
+	// Makes renderMesh draw the buffers of the primitive, they are uploaded only by the first RenderMesh using
+	// them. Quantized and full precision vertices are separate entries, following the RenderMesh setting.
+	// Analytic primitives in full precision are written with RenderMesh::setPrimitiveData, without a CPU mesh
+	void setMeshData(RenderMesh& renderMesh, const PrimitivesFactory::PrimitiveDesc& desc);
+
+private:
+	inline static std::unique_ptr<PrimitiveCache> instance = nullptr;
+	std::map<PrimitivesFactory::PrimitiveDesc, std::weak_ptr<Mesh>> mMeshes;
+	std::map<std::pair<PrimitivesFactory::PrimitiveDesc, bool>, std::weak_ptr<RenderMesh::MeshBuffers>> mBuffers;
+};
+
+}
+
+#endif
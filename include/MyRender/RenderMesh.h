@@ -6,6 +6,10 @@
 #include "MyRender/System.h"
 #include "MyRender/shaders/Shader.h"
 #include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshSoA.h"
+#include "MyRender/utils/MeshSimplifier.h"
+#include "MyRender/utils/MeshFile.h"
+#include "MyRender/utils/PrimitivesFactory.h"
 
 namespace myrender
 {
@@ -13,26 +17,105 @@ namespace myrender
 class RenderMesh : public System
 {
 public:
+    static constexpr uint32_t POSITION_LOCATION = 0;
+    static constexpr uint32_t NORMAL_LOCATION = 1;
+    static constexpr uint32_t TANGENT_LOCATION = 2;
+    static constexpr uint32_t TEXCOORD_LOCATION = 3;
+
     struct VertexParameterLayout {
         GLenum type;
         int size;
+        bool normalized = false; // Integer types are read as [0, 1] or [-1, 1] floats
         VertexParameterLayout() {}
-        VertexParameterLayout(GLenum type, int size) : type(type), size(size) {}
+        VertexParameterLayout(GLenum type, int size, bool normalized = false) : type(type), size(size), normalized(normalized) {}
+    };
+
+    struct BufferData
+    {
+        BufferData(unsigned int VBO, size_t elementsSize) : 
+            VBO(VBO), elementsSize(elementsSize) {} 
+        unsigned int VBO;
+        size_t elementsSize;
+    };
+
+    struct LodRange
+    {
+        size_t firstIndex;
+        size_t numIndices;
+        float error;
+    };
+
+    // GPU side of the mesh data: the vertex array, its buffers and what is needed to draw them. Many RenderMesh
+    // can draw the same one, see setMeshBuffers, and the GL objects are deleted with the last of them
+    struct MeshBuffers
+    {
+        MeshBuffers() {}
+        ~MeshBuffers();
+        MeshBuffers(const MeshBuffers&) = delete;
+        MeshBuffers& operator=(const MeshBuffers&) = delete;
+
+        unsigned int VAO = 0;
+        std::vector<BufferData> buffersData;
+        uint32_t nextAttributeIndex = 0;
+        bool hasElementBuffer = false;
+        unsigned int EBO = 0;
+        GLenum indexType = GL_UNSIGNED_INT; // Smallest type that fits the indices
+        GLenum format = GL_TRIANGLES;
+        size_t indexArraySize = 0; // Number of indices
+        size_t dataArraySize = 0;
+        bool allocated = false;
+
+        // Decoding of the quantized vertices
+        glm::vec3 positionOffset = glm::vec3(0.0f);
+        glm::vec3 positionScale = glm::vec3(1.0f);
+        bool octahedralNormals = false;
+
+        std::vector<LodRange> lods;
+        BoundingBox bbox;
     };
 
-    ~RenderMesh();
     void start() override;
     void draw(Camera* camera) override;
 	void drawGui() override;
 
-	uint32_t setVertexData(std::vector<VertexParameterLayout> parameters, void* data, size_t numElements);
-    void setVertexData(uint32_t bufferId, void* data, size_t numElements);
+	uint32_t setVertexData(std::vector<VertexParameterLayout> parameters, const void* data, size_t numElements);
+    void setVertexData(uint32_t bufferId, const void* data, size_t numElements);
     void setIndexData(std::vector<unsigned int>& indices);
-	void setIndexData(unsigned int* data, size_t numElements);
-	void setIndexData(unsigned int* data, size_t numElements, GLenum mode);
+	void setIndexData(const unsigned int* data, size_t numElements);
+	// The indices are uploaded as GL_UNSIGNED_BYTE or GL_UNSIGNED_SHORT when the largest one fits
+	void setIndexData(const unsigned int* data, size_t numElements, GLenum mode);
+	GLenum getIndexType() const { return mBuffers->indexType; }
+    // The setMeshData functions upload into new buffers when the current ones are shared.
+    // The attributes of a Mesh are the positions, the normals, the tangents and the texture coordinates at
+    // the locations below, each uploaded when the mesh has it for every vertex. Tangents also need the normals
     void setMeshData(Mesh& mesh);
+    void setMeshData(MeshSoA& mesh);
+    // Uploads straight from the file mapping, including the LOD levels stored in the file
+    void setMeshData(const MappedMesh& mesh);
+    // Writes an analytic primitive straight into one interleaved position and normal buffer, without a Mesh.
+    // The vertices are not quantized
+    void setPrimitiveData(const PrimitivesFactory::PrimitiveDesc& desc);
+    // When enabled the next setMeshData uploads positions as unorm16 relative to the bounds of the uploaded
+    // vertices, computed again rather than taken from the mesh or the file, and normals
+    // as octahedral snorm16, 12 bytes per vertex instead of 24. The built-in shaders decode both
+    void setVertexQuantization(bool enabled) { mQuantizeVertices = enabled; }
+    bool isVertexQuantizationEnabled() const { return mQuantizeVertices; }
+    // When enabled setMeshData(Mesh&) releases the arrays of the mesh once they are uploaded, keeping only its
+    // bounding box. Other meshes sharing the arrays keep them
+    void setReleaseMeshData(bool enabled) { mReleaseMeshData = enabled; }
+    bool isReleasingMeshData() const { return mReleaseMeshData; }
+    // Uploads all the levels to the index buffer. Each frame draws the coarsest level whose error,
+    // projected with the bounding box of the mesh data, is below the threshold in pixels
+    void setLods(const std::vector<MeshSimplifier::MeshLod>& lods);
+    // Draws the buffers of another RenderMesh, without copying them. The other setters modify the buffers
+    // for every RenderMesh using them
+    void setMeshBuffers(std::shared_ptr<MeshBuffers> buffers) { mBuffers = std::move(buffers); }
+    const std::shared_ptr<MeshBuffers>& getMeshBuffers() const { return mBuffers; }
+    void setLodThreshold(float pixels) { mLodThreshold = pixels; }
+    float getLodThreshold() const { return mLodThreshold; }
+    uint32_t getCurrentLod() const { return mCurrentLod; }
 	void setDrawMode(GLenum mode) { mDrawMode = mode; }
-    void setDataMode(GLenum mode) { mFormat = mode; }
+    void setDataMode(GLenum mode) { mBuffers->format = mode; }
 	void setShader(Shader&& shader) { mShader = std::make_unique<Shader>(shader); }
     Shader& getShader() { return *mShader; }
 	void drawWireframe(bool b) { mPrintWireframe = b; }
@@ -44,29 +127,32 @@ public:
     void setTransform(glm::mat4x4 transfrom) { mTransform = transfrom; }
 
 private:
-    struct BufferData
-    {
-        BufferData(unsigned int VBO, size_t elementsSize) : 
-            VBO(VBO), elementsSize(elementsSize) {} 
-        unsigned int VBO;
-        size_t elementsSize;
-    };
+    std::shared_ptr<MeshBuffers> mBuffers = std::make_shared<MeshBuffers>();
+
+    // Replaces the buffers by new ones if they are shared
+    void unshareMeshBuffers();
+    // Disables the locations of the mesh attributes so the next uploads start from POSITION_LOCATION
+    void resetMeshAttributes();
+    void uploadVec3Array(const Vec3Array& array);
+    // Maps the whole buffer for writing, returns nullptr on failure
+    void* mapVertexBuffer(uint32_t bufferId, size_t numBytes);
+    void unmapVertexBuffer();
+
+    template<typename VertexArray, typename NormalArray>
+    void uploadQuantizedVertices(const VertexArray& vertices, const NormalArray& normals);
+    void setVertexDecodingUniforms(Shader& shader);
+
+    bool mQuantizeVertices = false;
+    bool mReleaseMeshData = false;
 
-    bool mMeshAllocated = false;
-    unsigned int mVAO;        
-    std::vector<BufferData> mBuffersData;
-    bool mHasElementBuffer = false;
-    unsigned int mEBO;
+    uint32_t mCurrentLod = 0;
+    float mLodThreshold = 1.0f;
 
-    uint32_t mNextAttributeIndex = 0;
-	
-    size_t mIndexArraySize = 0; // Number of inices
-    size_t mDataArraySize = 0;
+    uint32_t selectLod(Camera* camera) const;
 
     bool mPrintSurface = true;
     bool mPrintWireframe = false;
 
-    GLenum mFormat = GL_TRIANGLES;
     GLenum mDrawMode = GL_FILL;
 
     std::unique_ptr<Shader> mShader;
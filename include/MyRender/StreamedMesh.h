@@ -0,0 +1,80 @@
+#ifndef STREAMED_MESH_H
+#define STREAMED_MESH_H
+
+#include <glad/glad.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MyRender/System.h"
+#include "MyRender/shaders/Shader.h"
+#include "MyRender/utils/ChunkedMesh.h"
+
+namespace myrender
+{
+
+// Draws a .mrchunks file larger than the memory. Only the pages near the camera are drawn, and they are
+// uploaded on demand from the file mapping into a fixed pool of GPU slots, evicting the least recently
+// used ones. Memory use is bounded by the budget of the pool and the page table
+class StreamedMesh : public System
+{
+public:
+	StreamedMesh() {}
+	~StreamedMesh();
+	StreamedMesh(const StreamedMesh&) = delete;
+	StreamedMesh& operator=(const StreamedMesh&) = delete;
+
+	void start() override;
+	void draw(Camera* camera) override;
+	void drawGui() override;
+
+	bool open(const std::string& path);
+	const MappedChunkedMesh& getChunkedMesh() const { return mMesh; }
+
+	// Bytes of GPU memory for the pages, rounded down to whole slots and at least one. Empties the pool
+	void setMemoryBudget(size_t bytes);
+	size_t getMemoryBudget() const { return mMemoryBudget; }
+	// Pages whose bounds are farther from the camera than this, in model space, are not drawn
+	void setLoadDistance(float distance) { mLoadDistance = distance; }
+	float getLoadDistance() const { return mLoadDistance; }
+	// Limits the uploads of a frame, the remaining pages are loaded in the next ones nearest first
+	void setMaxLoadsPerFrame(uint32_t loads) { mMaxLoadsPerFrame = loads; }
+	uint32_t getMaxLoadsPerFrame() const { return mMaxLoadsPerFrame; }
+
+	void setShader(Shader&& shader) { mShader = std::make_unique<Shader>(shader); }
+	Shader& getShader() { return *mShader; }
+
+	const glm::mat4x4& getTransform() const { return mTransform; }
+	void setTransform(glm::mat4x4 transfrom) { mTransform = transfrom; }
+
+private:
+	MappedChunkedMesh mMesh;
+	PageCache mCache;
+
+	unsigned int mVAO = 0;
+	unsigned int mVBO = 0;
+	unsigned int mEBO = 0;
+	bool mAllocated = false;
+
+	size_t mMemoryBudget = 256u << 20;
+	float mLoadDistance = 1.0f;
+	uint32_t mMaxLoadsPerFrame = 8;
+
+	std::vector<uint32_t> mVisiblePages;
+	std::vector<bool> mInvalidPages; // Pages whose indices failed the check on load
+	uint32_t mNumDrawnPages = 0;
+	uint32_t mNumFrameLoads = 0;
+	size_t mNumLoads = 0;
+
+	// Creates the pool buffers for the budget
+	void allocatePool();
+	void freePool();
+	void uploadPage(uint32_t page, uint32_t slot);
+
+	std::unique_ptr<Shader> mShader;
+
+	glm::mat4x4 mTransform = glm::mat4x4(1.0f);
+};
+
+}
+
+#endif // STREAMED_MESH_H
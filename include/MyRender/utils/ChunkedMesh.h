@@ -0,0 +1,161 @@
+#ifndef CHUNKED_MESH_H
+#define CHUNKED_MESH_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshFile.h"
+#include "MyRender/utils/MappedFile.h"
+
+namespace myrender
+{
+
+// Binary .mrchunks file of a mesh split in pages of triangles close in space, for meshes larger than the memory.
+// Each page is self contained, with its own vertices and 16 bit indices, so it can be uploaded to the GPU
+// straight from the file mapping. The page table is at the end of the file. Little endian only
+namespace ChunkedMeshFile
+{
+    constexpr uint32_t MAGIC = 0x434d524d; // "MRMC" in the file
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t PAGE_ALIGNMENT = 4096;
+    constexpr uint32_t MAX_PAGE_VERTICES = 1u << 16;
+    constexpr uint32_t DEFAULT_PAGE_TRIANGLES = 1u << 15;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numPages;
+        uint32_t maxPageVertices; // Largest page, what a GPU slot has to hold
+        uint32_t maxPageIndices;
+        uint32_t padding;
+        BoundingBox bounds;
+        uint64_t pageTableOffset;
+        uint64_t fileSize;
+    };
+
+    struct Page
+    {
+        BoundingBox bounds;
+        uint32_t numVertices;
+        uint32_t numIndices;
+        uint64_t offset; // PageVertex array followed by the uint16_t indices
+    };
+
+    struct PageVertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+
+    // Sorts the triangles along the Z-order curve of the mesh bounds and cuts that order in pages of at most
+    // pageTriangles triangles and MAX_PAGE_VERTICES vertices, written as they are completed. Besides the input
+    // it only keeps a few integers per triangle and one per vertex, so it also works on a mapped mesh. Without
+    // normals each page gets its own, which can differ slightly along the page borders
+    bool write(const std::string& path, const glm::vec3* vertices, const glm::vec3* normals, size_t numVertices,
+               const uint32_t* indices, size_t numIndices, uint32_t pageTriangles = DEFAULT_PAGE_TRIANGLES, uint32_t numThreads = 0);
+
+    inline bool write(const std::string& path, const Mesh& mesh, uint32_t pageTriangles = DEFAULT_PAGE_TRIANGLES, uint32_t numThreads = 0)
+    {
+        const bool hasNormals = mesh.getNormals().size() == mesh.getVertices().size();
+        return write(path, mesh.getVertices().data(), hasNormals ? mesh.getNormals().data() : nullptr, mesh.getVertices().size(),
+                     mesh.getIndices().data(), mesh.getIndices().size(), pageTriangles, numThreads);
+    }
+
+    inline bool write(const std::string& path, const MappedMesh& mesh, uint32_t pageTriangles = DEFAULT_PAGE_TRIANGLES, uint32_t numThreads = 0)
+    {
+        return write(path, mesh.getVertices(), mesh.getNormals(), mesh.getNumVertices(), mesh.getIndices(), mesh.getNumIndices(),
+                     pageTriangles, numThreads);
+    }
+}
+
+// Read only view of a .mrchunks file. Only the page table is copied, the pages are read from the mapping
+// when they are accessed. open checks that the page table and the pages stay within the file, but not the
+// indices of the pages, see hasValidIndices
+class MappedChunkedMesh
+{
+public:
+    MappedChunkedMesh() {}
+    ~MappedChunkedMesh() { close(); }
+    MappedChunkedMesh(const MappedChunkedMesh&) = delete;
+    MappedChunkedMesh& operator=(const MappedChunkedMesh&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mFile.isOpen(); }
+
+    uint32_t getNumPages() const { return static_cast<uint32_t>(mPages.size()); }
+    const ChunkedMeshFile::Page& getPage(uint32_t page) const { return mPages[page]; }
+    const ChunkedMeshFile::PageVertex* getPageVertices(uint32_t page) const
+    {
+        return reinterpret_cast<const ChunkedMeshFile::PageVertex*>(mFile.getData() + mPages[page].offset);
+    }
+    const uint16_t* getPageIndices(uint32_t page) const
+    {
+        return reinterpret_cast<const uint16_t*>(getPageVertices(page) + mPages[page].numVertices);
+    }
+    // Checks that the indices of the page stay within its vertices. It reads the whole page, so it is meant to
+    // be done when the page is loaded rather than for all of them in open
+    bool hasValidIndices(uint32_t page) const;
+    uint32_t getMaxPageVertices() const { return mHeader.maxPageVertices; }
+    uint32_t getMaxPageIndices() const { return mHeader.maxPageIndices; }
+    const BoundingBox& getBoundingBox() const { return mHeader.bounds; }
+
+    // Pages whose bounds are within maxDistance of the point, nearest first
+    void selectPages(const glm::vec3& point, float maxDistance, std::vector<uint32_t>& pages) const;
+
+private:
+    MappedFile mFile;
+    ChunkedMeshFile::Header mHeader = {};
+    std::vector<ChunkedMeshFile::Page> mPages;
+};
+
+// Least recently used assignment of pages to a fixed number of slots. Slots used in the current frame
+// are never evicted, so a frame cannot throw away what it draws
+class PageCache
+{
+public:
+    static constexpr uint32_t NONE = ~0u;
+
+    PageCache() {}
+    PageCache(uint32_t numSlots, uint32_t numPages) { reset(numSlots, numPages); }
+
+    // Empties the cache
+    void reset(uint32_t numSlots, uint32_t numPages);
+    void nextFrame() { mFrame++; }
+
+    // Slot holding the page or NONE
+    uint32_t find(uint32_t page) const { return mPageSlots[page]; }
+    // Marks the slot as used in this frame
+    void touch(uint32_t slot);
+    // Takes the least recently used slot for the page, which has to be loaded into it, and marks it as used.
+    // evictedPage is the page it held or NONE. Returns NONE when all the slots are used in this frame
+    uint32_t acquire(uint32_t page, uint32_t& evictedPage);
+
+    uint32_t getNumSlots() const { return static_cast<uint32_t>(mSlots.size()); }
+    uint32_t getNumResidentPages() const { return mNumResident; }
+
+private:
+    struct Slot
+    {
+        uint32_t page = NONE;
+        uint32_t previous = NONE; // More recently used
+        uint32_t next = NONE;     // Less recently used
+        uint64_t lastFrame = 0;
+    };
+
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mPageSlots;
+    uint32_t mFirst = NONE; // Most recently used
+    uint32_t mLast = NONE;
+    uint64_t mFrame = 1;
+    uint32_t mNumResident = 0;
+
+    void unlink(uint32_t slot);
+    void pushFront(uint32_t slot);
+};
+
+}
+
+#endif
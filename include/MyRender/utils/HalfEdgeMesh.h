@@ -0,0 +1,98 @@
+#ifndef HALF_EDGE_MESH_H
+#define HALF_EDGE_MESH_H
+
+#include <vector>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+// Half edge connectivity of a triangle mesh. Half edge h is the corner h of the index buffer, it goes from
+// the vertex of that corner to the next one of triangle h / 3, so next, prev, the triangle and the vertices
+// are implicit and only the twins and one outgoing half edge per vertex are stored, 4 bytes each.
+// It keeps a pointer to the mesh and has to be rebuilt after changing its indices
+class HalfEdgeMesh
+{
+public:
+    static constexpr uint32_t INVALID = ~0u;
+    // Twin of the half edges of an edge shared by more than two of them, or by two going the same way
+    static constexpr uint32_t NON_MANIFOLD = ~0u - 1;
+
+    HalfEdgeMesh() {}
+    HalfEdgeMesh(const Mesh& mesh, uint32_t numThreads = 0) { build(mesh, numThreads); }
+
+    void build(const Mesh& mesh, uint32_t numThreads = 0);
+
+    uint32_t getNumHalfEdges() const { return static_cast<uint32_t>(mTwins.size()); }
+    uint32_t getNumVertices() const { return static_cast<uint32_t>(mVertexHalfEdges.size()); }
+
+    static uint32_t getTriangle(uint32_t halfEdge) { return halfEdge / 3; }
+    static uint32_t getNext(uint32_t halfEdge) { return halfEdge % 3 == 2 ? halfEdge - 2 : halfEdge + 1; }
+    static uint32_t getPrev(uint32_t halfEdge) { return halfEdge % 3 == 0 ? halfEdge + 2 : halfEdge - 1; }
+    uint32_t getFrom(uint32_t halfEdge) const { return mMesh->getIndices()[halfEdge]; }
+    uint32_t getTo(uint32_t halfEdge) const { return mMesh->getIndices()[getNext(halfEdge)]; }
+    // INVALID on the boundary, NON_MANIFOLD on non manifold edges
+    uint32_t getTwin(uint32_t halfEdge) const { return mTwins[halfEdge]; }
+    bool hasTwin(uint32_t halfEdge) const { return mTwins[halfEdge] < NON_MANIFOLD; }
+
+    bool isBoundary(uint32_t halfEdge) const { return mTwins[halfEdge] == INVALID; }
+    bool isNonManifold(uint32_t halfEdge) const { return mTwins[halfEdge] == NON_MANIFOLD; }
+    // Outgoing half edge of the vertex, the one on the boundary if there is one. INVALID for unreferenced vertices
+    uint32_t getVertexHalfEdge(uint32_t vertex) const { return mVertexHalfEdges[vertex]; }
+    bool isBoundaryVertex(uint32_t vertex) const
+    {
+        return mVertexHalfEdges[vertex] != INVALID && !hasTwin(mVertexHalfEdges[vertex]);
+    }
+
+    // Calls func(halfEdge) for each half edge leaving the vertex, counter clockwise starting from the boundary
+    // if the vertex is on one. Around a non manifold vertex only the fan of getVertexHalfEdge is visited
+    template<typename F>
+    void forEachOutgoing(uint32_t vertex, F&& func) const
+    {
+        const uint32_t start = mVertexHalfEdges[vertex];
+        if(start == INVALID) return;
+        uint32_t halfEdge = start;
+        do
+        {
+            func(halfEdge);
+            const uint32_t incoming = getPrev(halfEdge);
+            if(!hasTwin(incoming)) return;
+            halfEdge = mTwins[incoming];
+        } while(halfEdge != start);
+    }
+
+    // Calls func(neighbour) for each vertex of the one ring, in the order of forEachOutgoing. On the boundary
+    // this includes the vertex at the start of the last incoming half edge
+    template<typename F>
+    void forEachNeighbour(uint32_t vertex, F&& func) const
+    {
+        uint32_t last = INVALID;
+        forEachOutgoing(vertex, [&](uint32_t halfEdge)
+        {
+            func(getTo(halfEdge));
+            last = halfEdge;
+        });
+        if(last != INVALID && !hasTwin(getPrev(last))) func(getFrom(getPrev(last)));
+    }
+
+    uint32_t getNumBoundaryHalfEdges() const { return mNumBoundaryHalfEdges; }
+    uint32_t getNumNonManifoldHalfEdges() const { return mNumNonManifoldHalfEdges; }
+    // Vertices whose triangles do not form a single fan, sorted
+    const std::vector<uint32_t>& getNonManifoldVertices() const { return mNonManifoldVertices; }
+    bool isManifold() const { return mNumNonManifoldHalfEdges == 0 && mNonManifoldVertices.empty(); }
+    bool isClosed() const { return mNumBoundaryHalfEdges == 0; }
+
+    const Mesh* getMesh() const { return mMesh; }
+
+private:
+    const Mesh* mMesh = nullptr;
+    std::vector<uint32_t> mTwins;
+    std::vector<uint32_t> mVertexHalfEdges;
+    uint32_t mNumBoundaryHalfEdges = 0;
+    uint32_t mNumNonManifoldHalfEdges = 0;
+    std::vector<uint32_t> mNonManifoldVertices;
+};
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef ISOSURFACE_EXTRACTOR_H
+#define ISOSURFACE_EXTRACTOR_H
+
+#include <memory>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/SdfBaker.h"
+
+namespace myrender
+{
+
+// Triangulation of the isosurface of a scalar volume with dual contouring (surface nets). Each cell the
+// surface crosses gets one vertex at the mean of its edge crossings, and each crossed edge a quad between
+// the four cells around it. Slabs of cells along z run in parallel, and the vertices of the cells on a slab
+// border are numbered the same way by both slabs, so they are not duplicated. Normals come from the
+// gradient of the field. The result can be given to RenderMesh::setMeshData
+namespace IsosurfaceExtractor
+{
+    // values are resolution.x * resolution.y * resolution.z samples at origin + voxelSize * (x, y, z), with
+    // x varying fastest. The inside, values below isoValue, is behind the triangles
+    std::shared_ptr<Mesh> extract(const float* values, const glm::uvec3& resolution, const glm::vec3& origin, float voxelSize,
+                                  float isoValue = 0.0f, uint32_t numThreads = 0);
+
+    inline std::shared_ptr<Mesh> extract(const SdfGrid& grid, float isoValue = 0.0f, uint32_t numThreads = 0)
+    {
+        return extract(grid.values.data(), grid.resolution, grid.origin, grid.voxelSize, isoValue, numThreads);
+    }
+}
+
+}
+
+#endif
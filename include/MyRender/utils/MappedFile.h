@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace myrender
+{
+
+// Read only memory mapping of a whole file. The pages are read from disk on first access
+class MappedFile
+{
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Fails on empty files. sequential hints the system to read ahead
+    bool open(const std::string& path, bool sequential = true);
+    void close();
+    bool isOpen() const { return mData != nullptr; }
+
+    const uint8_t* getData() const { return mData; }
+    size_t getSize() const { return mSize; }
+
+private:
+    const uint8_t* mData = nullptr;
+    size_t mSize = 0;
+    void* mFileHandle = nullptr;    // Only used on Windows
+    void* mMappingHandle = nullptr; // Only used on Windows
+};
+
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
+#include "MyRender/utils/SharedArray.h"
 
 namespace myrender
 {
@@ -33,8 +34,36 @@ struct BoundingBox
         min -= glm::vec3(margin);
         max += glm::vec3(margin);
     }
+
+    void addPoint(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void addBoundingBox(const BoundingBox& box)
+    {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
 };
 
+// Compressed list of the triangle corners incident to each vertex.
+// The corners of vertex v are corners[offsets[v]] ... corners[offsets[v+1]-1],
+// where a corner c refers to the index mIndices[c] of the triangle c / 3.
+struct VertexAdjacency
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> corners;
+
+    uint32_t getNumCorners(uint32_t vertexId) const
+    {
+        return offsets[vertexId + 1] - offsets[vertexId];
+    }
+};
+
+// The arrays are shared between copies of a mesh until one of them modifies them, so copies for instancing
+// cost no memory. The non const getters copy a shared array first, read through a const Mesh to avoid it
 class Mesh
 {
 public:
@@ -42,24 +71,62 @@ public:
     Mesh(glm::vec3* vertices, uint32_t numVertices,
          uint32_t* indices, uint32_t numIndices);
 
-    std::vector<glm::vec3>& getVertices() { return mVertices; }
-    const std::vector<glm::vec3>& getVertices() const { return mVertices; }
+    std::vector<glm::vec3>& getVertices() { return mVertices.edit(); }
+    const std::vector<glm::vec3>& getVertices() const { return mVertices.get(); }
+
+    std::vector<uint32_t>& getIndices() { return mIndices.edit(); }
+    const std::vector<uint32_t>& getIndices() const { return mIndices.get(); }
 
-    std::vector<uint32_t>& getIndices() { return mIndices; }
-    const std::vector<uint32_t>& getIndices() const { return mIndices; }
+    std::vector<glm::vec3>& getNormals() { return mNormals.edit(); }
+    const std::vector<glm::vec3>& getNormals() const { return mNormals.get(); }
 
-    std::vector<glm::vec3>& getNormals() { return mNormals; }
-    const std::vector<glm::vec3>& getNormals() const { return mNormals; }
+    // Optional, empty or one per vertex
+    std::vector<glm::vec2>& getTexCoords() { return mTexCoords.edit(); }
+    const std::vector<glm::vec2>& getTexCoords() const { return mTexCoords.get(); }
+
+    // xyz is the unit tangent and w the sign of the bitangent, which is w * cross(normal, tangent)
+    std::vector<glm::vec4>& getTangents() { return mTangents.edit(); }
+    const std::vector<glm::vec4>& getTangents() const { return mTangents.get(); }
+
+    // Drops the arrays of this mesh, for example once they are on the GPU. Copies sharing them keep them.
+    // The bounding box is kept
+    void releaseData();
+    // True if any array is shared with another mesh
+    bool isShared() const;
 
     const BoundingBox& getBoundingBox() const { return mBBox; }
 
-    void computeBoundingBox();
-    void computeNormals();
-    void applyTransform(glm::mat4 trans);
+    // Below this number of vertices the bounding box and transform kernels run in a single thread
+    static constexpr size_t PARALLEL_KERNELS_MIN_VERTICES = 1 << 18;
+    // Texture coordinates tolerance of weld, well below a texel of a 16k texture
+    static constexpr float DEFAULT_WELD_TEXCOORD_EPSILON = 1e-5f;
+
+    void computeBoundingBox(uint32_t numThreads = 0);
+    // Computes angle weighted vertex normals. numThreads = 0 uses all the hardware threads
+    void computeNormals(uint32_t numThreads = 0);
+    VertexAdjacency computeVertexAdjacency(uint32_t numThreads = 0) const;
+    // Computes MikkTSpace tangents from the texture coordinates and the normals, which are computed first
+    // if missing. The results match it when the vertices are already split where the tangent frames differ,
+    // as at the texture seams. Returns false if there are no texture coordinates
+    bool computeTangents(uint32_t numThreads = 0);
+    // Transforms the vertices and updates the bounding box in the same pass
+    void applyTransform(glm::mat4 trans, uint32_t numThreads = 0);
+    // Merges the vertices closer than epsilon and rewrites the indices in place. Each group keeps the
+    // position and normal of its lowest index vertex, and the triangles that collapse are removed.
+    // With texture coordinates they must also be closer than texCoordEpsilon, in texture space rather than
+    // in model units, so the UV seams are kept while the rounding noise of the coordinates is ignored.
+    // Returns the remap table (remap[oldIndex] = newIndex) to apply to other per vertex attributes.
+    // The texture coordinates and tangents are compacted as the normals
+    std::vector<uint32_t> weld(float epsilon, uint32_t numThreads = 0, float texCoordEpsilon = DEFAULT_WELD_TEXCOORD_EPSILON);
 private:
-    std::vector<glm::vec3> mVertices;
-    std::vector<uint32_t> mIndices;
-    std::vector<glm::vec3> mNormals;
+    friend class MeshSoA;
+    friend class MappedMesh;
+
+    SharedArray<glm::vec3> mVertices;
+    SharedArray<uint32_t> mIndices;
+    SharedArray<glm::vec3> mNormals;
+    SharedArray<glm::vec2> mTexCoords;
+    SharedArray<glm::vec4> mTangents;
     BoundingBox mBBox;
 };
 
@@ -0,0 +1,97 @@
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <cfloat>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+struct Ray
+{
+    Ray() {}
+    Ray(const glm::vec3& origin, const glm::vec3& direction, float tMax = FLT_MAX)
+        : origin(origin), direction(direction), tMax(tMax) {}
+
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f); // Does not need to be normalized, t is in its units
+    float tMin = 0.0f;
+    float tMax = FLT_MAX;
+};
+
+struct RayHit
+{
+    uint32_t triangle = ~0u;
+    float t = FLT_MAX;
+    glm::vec2 barycentric = glm::vec2(0.0f); // Weights of the second and third vertex
+};
+
+struct NearestPoint
+{
+    uint32_t triangle = ~0u;
+    glm::vec3 point = glm::vec3(0.0f);
+    float distance = FLT_MAX;
+};
+
+// Bounding volume hierarchy over the triangles of a mesh, built with binned SAH. It keeps a pointer to
+// the mesh, so it has to be refit after moving the vertices (e.g. Mesh::applyTransform) and rebuilt after
+// changing the indices
+class MeshBVH
+{
+public:
+    static constexpr uint32_t MAX_LEAF_TRIANGLES = 8;
+
+    // Leaves have numTriangles > 0 and reference a range of mTriangles. Interior nodes have
+    // their two children next to each other starting at firstChildOrTriangle
+    struct Node
+    {
+        glm::vec3 min;
+        uint32_t firstChildOrTriangle;
+        glm::vec3 max;
+        uint32_t numTriangles;
+
+        bool isLeaf() const { return numTriangles > 0; }
+    };
+    static_assert(sizeof(Node) == 32, "MeshBVH::Node must be 32 bytes");
+
+    MeshBVH() {}
+    MeshBVH(const Mesh& mesh, uint32_t numThreads = 0) { build(mesh, numThreads); }
+
+    void build(const Mesh& mesh, uint32_t numThreads = 0);
+    // Recomputes the bounds keeping the tree, which gets slower to traverse the more the vertices move
+    void refit(uint32_t numThreads = 0);
+
+    // Closest hit in [tMin, tMax]. Returns false if nothing is hit
+    bool intersect(const Ray& ray, RayHit& hit) const;
+    // Whether anything is hit in [tMin, tMax], stops at the first hit found
+    bool intersectAny(const Ray& ray) const;
+    // Appends every hit in [tMin, tMax] sorted by distance and returns their number. Triangles sharing
+    // an edge or a vertex crossed by the ray are all reported
+    size_t intersectAll(const Ray& ray, std::vector<RayHit>& hits) const;
+    // Closest point of the mesh within maxDistance. Returns false if there is none
+    bool findNearestPoint(const glm::vec3& point, NearestPoint& result, float maxDistance = FLT_MAX) const;
+
+    // Closest hits of many rays in parallel
+    void intersect(const std::vector<Ray>& rays, std::vector<RayHit>& hits, uint32_t numThreads = 0) const;
+
+    const std::vector<Node>& getNodes() const { return mNodes; }
+    // Triangle ids in leaf order, the leaves reference ranges of it
+    const std::vector<uint32_t>& getTriangles() const { return mTriangles; }
+    const Mesh* getMesh() const { return mMesh; }
+    BoundingBox getBoundingBox() const;
+
+private:
+    const Mesh* mMesh = nullptr;
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mTriangles; // Triangle ids sorted by leaf
+
+    // Calls onHit(hit, tMax) for each hit closer than tMax, which it can lower. Returning true stops the traversal
+    template<typename F>
+    bool traverse(const Ray& ray, F&& onHit) const;
+};
+
+}
+
+#endif
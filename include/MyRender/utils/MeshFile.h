@@ -0,0 +1,108 @@
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MappedFile.h"
+#include "MyRender/utils/MeshSimplifier.h"
+
+namespace myrender
+{
+
+// Binary .mrmesh container. A header and a section table are followed by the sections, each one aligned to
+// SECTION_ALIGNMENT bytes so the arrays can be used in place from a memory mapping. Little endian only.
+// Readers skip the sections they do not know, so new section types do not need a new version
+namespace MeshFile
+{
+    constexpr uint32_t MAGIC = 0x484d524d; // "MRMH" in the file
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t SECTION_ALIGNMENT = 64;
+
+    enum class SectionType : uint32_t
+    {
+        POSITIONS = 1,  // glm::vec3 per vertex
+        NORMALS = 2,    // glm::vec3 per vertex
+        INDICES = 3,    // uint32_t, all the LOD levels one after the other
+        BOUNDS = 4,     // One BoundingBox
+        LOD_RANGES = 5  // LodRange per level, level 0 is the mesh
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numSections;
+        uint32_t padding;
+        uint64_t fileSize;
+    };
+
+    struct Section
+    {
+        uint32_t type;
+        uint32_t elementSize;
+        uint64_t offset;
+        uint64_t numElements;
+    };
+
+    struct LodRange
+    {
+        uint64_t firstIndex;
+        uint64_t numIndices;
+        float error;
+        uint32_t padding;
+    };
+
+    // Writes the mesh and optionally its LOD chain, as returned by MeshSimplifier::buildLodChain.
+    // The stored bounds are computed from the positions, not taken from the mesh
+    bool write(const std::string& path, const Mesh& mesh, const std::vector<MeshSimplifier::MeshLod>& lods = {});
+}
+
+// Read only view of a .mrmesh file mapped in memory. The arrays point into the mapping, so the vertices are
+// not read from disk until they are accessed. open checks that the sections, the lods and the indices stay
+// within the file and the vertices, which reads the index section once
+class MappedMesh
+{
+public:
+    MappedMesh() {}
+    ~MappedMesh() { close(); }
+    MappedMesh(const MappedMesh&) = delete;
+    MappedMesh& operator=(const MappedMesh&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mFile.isOpen(); }
+
+    const glm::vec3* getVertices() const { return mVertices; }
+    size_t getNumVertices() const { return mNumVertices; }
+    // nullptr when the file has no normals
+    const glm::vec3* getNormals() const { return mNormals; }
+    // Indices of level 0
+    const uint32_t* getIndices() const { return mIndices; }
+    size_t getNumIndices() const { return mLods.empty() ? mNumAllIndices : mLods[0].numIndices; }
+    const BoundingBox& getBoundingBox() const { return mBBox; }
+
+    // Indices of every level one after the other, the ranges are given by the lods
+    const uint32_t* getAllIndices() const { return mIndices; }
+    size_t getNumAllIndices() const { return mNumAllIndices; }
+    const std::vector<MeshFile::LodRange>& getLods() const { return mLods; }
+
+    // Copies the level 0 into a Mesh
+    Mesh toMesh() const;
+
+private:
+    MappedFile mFile;
+
+    const glm::vec3* mVertices = nullptr;
+    const glm::vec3* mNormals = nullptr;
+    size_t mNumVertices = 0;
+    const uint32_t* mIndices = nullptr;
+    size_t mNumAllIndices = 0;
+    BoundingBox mBBox;
+    std::vector<MeshFile::LodRange> mLods;
+};
+
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MESH_LOADER_H
+#define MESH_LOADER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+// Loaders of the common mesh formats. They map the file in memory and return nullptr on error
+namespace MeshLoader
+{
+    // Wavefront OBJ, only the positions, normals and faces are read. Polygons are triangulated as fans.
+    // The file is parsed in parallel in chunks split at line boundaries. When loadNormals is set and every
+    // face corner has a normal, each distinct position and normal pair becomes a vertex
+    std::shared_ptr<Mesh> loadObj(const std::string& path, bool loadNormals = true, uint32_t numThreads = 0);
+
+    // Called with the loaded fraction in [0, 1]. Returning false cancels the load, which then returns nullptr
+    using ProgressCallback = std::function<bool(float)>;
+
+    // Binary little endian PLY. Reads the vertex positions and normals and the face vertex indices,
+    // polygons are triangulated as fans. Faces that are all triangles are decoded in parallel
+    std::shared_ptr<Mesh> loadPly(const std::string& path, const ProgressCallback& progress = nullptr, uint32_t numThreads = 0);
+
+    // Binary STL. Each triangle gets its own three vertices with the facet normal. With weld the vertices
+    // closer than weldEpsilon are merged, and the normals are recomputed as smooth ones
+    std::shared_ptr<Mesh> loadStl(const std::string& path, bool weld = false, float weldEpsilon = 0.0f,
+                                  const ProgressCallback& progress = nullptr, uint32_t numThreads = 0);
+}
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/Parallel.h"
+
+namespace myrender
+{
+
+namespace MeshOptimizer
+{
+    // Size of the post-transform vertex cache assumed by the optimizer and the statistics
+    constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+
+    struct VertexCacheStatistics
+    {
+        size_t vertexShaderInvocations = 0;
+        float acmr = 0.0f; // Average cache miss ratio, invocations per triangle
+        float atvr = 0.0f; // Average transformed vertex ratio, invocations per referenced vertex
+    };
+
+    // Simulates a FIFO post-transform cache over the triangle list
+    VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& indices, size_t numVertices,
+                                             uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+    VertexCacheStatistics analyzeVertexCache(const Mesh& mesh, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Reorders the triangles for the post-transform cache with the Tipsify algorithm, in linear time.
+    // Call it on the mesh before RenderMesh::setMeshData, the vertices are not modified
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices,
+                             uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+    void optimizeVertexCache(Mesh& mesh, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Simulates the fetches of vertexSize bytes per vertex through a small FIFO cache of 64 byte lines.
+    // Returns the overfetch, bytes read from memory divided by the bytes of the referenced vertices
+    float analyzeVertexFetch(const std::vector<uint32_t>& indices, size_t numVertices, size_t vertexSize);
+
+    // Returns the remap table (remap[oldIndex] = newIndex) that numbers the vertices in order of first use
+    // by the indices. Unreferenced vertices are kept at the end in their original order
+    std::vector<uint32_t> computeVertexFetchRemap(const std::vector<uint32_t>& indices, size_t numVertices);
+
+    // Renumbers the vertices, their attributes and the indices in order of first use so the vertex fetches are
+    // sequential. Run it after optimizeVertexCache. The returned remap table can be applied to other per vertex
+    // attributes
+    std::vector<uint32_t> optimizeVertexFetch(Mesh& mesh, uint32_t numThreads = 0);
+
+    // Returns the remap table that numbers the vertices along the Z-order (Morton) curve of the box, so the
+    // vertices close in space are close in memory. The codes are sorted with a parallel radix sort
+    std::vector<uint32_t> computeMortonRemap(const std::vector<glm::vec3>& vertices, const BoundingBox& box, uint32_t numThreads = 0);
+    // Sorts the triangles along the Z-order curve of the box by their centroids
+    void sortTrianglesMorton(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& vertices, const BoundingBox& box,
+                             uint32_t numThreads = 0);
+    // Both in the bounding box of the mesh, which is computed if it was not, for the CPU passes over large meshes
+    // like computeNormals, the BVH build or the SDF baking. Run optimizeVertexCache afterwards for rendering.
+    // Returns the vertex remap table
+    std::vector<uint32_t> optimizeSpatialOrder(Mesh& mesh, uint32_t numThreads = 0);
+
+    // Moves each element i of the array to remap[i]
+    template<typename T>
+    void remapVertexAttribute(std::vector<T>& attribute, const std::vector<uint32_t>& remap, uint32_t numThreads = 0);
+
+    void remapIndices(std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap, uint32_t numThreads = 0);
+}
+
+template<typename T>
+void MeshOptimizer::remapVertexAttribute(std::vector<T>& attribute, const std::vector<uint32_t>& remap, uint32_t numThreads)
+{
+    if(attribute.empty()) return;
+    std::vector<T> result(attribute.size());
+    Parallel::forRange(0, attribute.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t i = begin; i < end; i++) result[remap[i]] = attribute[i];
+    }, numThreads);
+    attribute.swap(result);
+}
+
+}
+
+#endif
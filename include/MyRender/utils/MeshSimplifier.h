@@ -0,0 +1,39 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+#include <limits>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+namespace MeshSimplifier
+{
+    struct MeshLod
+    {
+        std::vector<uint32_t> indices;
+        float error = 0.0f; // Geometric error relative to the largest side of the mesh bounding box
+    };
+
+    // Simplifies the triangles with quadric error metrics by collapsing edges into one of their vertices.
+    // The vertices are not modified, so the result can be drawn with the vertex buffers of the original mesh.
+    // Stops when the number of indices reaches targetNumIndices or the next collapse would exceed targetError,
+    // relative to the largest side of the bounding box. Vertices on open borders only slide along the border
+    // and vertices sharing the position with other vertices (normal seams) are kept.
+    std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, const std::vector<glm::vec3>& vertices,
+                                   size_t targetNumIndices,
+                                   float targetError = std::numeric_limits<float>::max(),
+                                   float* resultError = nullptr, uint32_t numThreads = 0);
+
+    // Level 0 is the mesh itself and each next level is simplified from the previous one down to
+    // triangleRatios[i] of the original triangles. The chain ends early when a level cannot be reduced
+    std::vector<MeshLod> buildLodChain(const Mesh& mesh,
+                                       const std::vector<float>& triangleRatios = {0.5f, 0.25f, 0.125f, 0.0625f},
+                                       uint32_t numThreads = 0);
+}
+
+}
+
+#endif
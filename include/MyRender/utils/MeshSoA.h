@@ -0,0 +1,104 @@
+#ifndef MESH_SOA_H
+#define MESH_SOA_H
+
+#include <new>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+template<typename T, size_t Alignment>
+struct AlignedAllocator
+{
+    typedef T value_type;
+    template<typename U> struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+    AlignedAllocator() {}
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    // Resizing leaves the new elements default initialized, so converting a mesh writes each float only once
+    template<typename U>
+    void construct(U* p) { ::new(static_cast<void*>(p)) U; }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+    bool operator==(const AlignedAllocator&) const { return true; }
+    bool operator!=(const AlignedAllocator&) const { return false; }
+};
+
+// Alignment of the structure of arrays buffers, enough for full cache lines and AVX loads
+constexpr size_t SOA_ALIGNMENT = 64;
+typedef std::vector<float, AlignedAllocator<float, SOA_ALIGNMENT>> AlignedFloatVector;
+
+// Array of vec3 stored as one array per component
+struct Vec3Array
+{
+    AlignedFloatVector x;
+    AlignedFloatVector y;
+    AlignedFloatVector z;
+
+    size_t size() const { return x.size(); }
+    void resize(size_t size) { x.resize(size); y.resize(size); z.resize(size); }
+    void clear() { x.clear(); y.clear(); z.clear(); }
+
+    glm::vec3 get(size_t i) const { return glm::vec3(x[i], y[i], z[i]); }
+    void set(size_t i, const glm::vec3& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+
+    // Vectorized conversions from and to interleaved vec3 arrays
+    void assign(const glm::vec3* src, size_t size, uint32_t numThreads = 0);
+    void copyTo(glm::vec3* dst, uint32_t numThreads = 0) const;
+};
+
+// Version of Mesh storing the vertices and normals as structure of arrays,
+// so the per vertex passes run over contiguous and aligned floats
+class MeshSoA
+{
+public:
+    MeshSoA() {}
+    explicit MeshSoA(const Mesh& mesh, uint32_t numThreads = 0);
+
+    // Conversion to the interleaved layout
+    void toMesh(Mesh& mesh, uint32_t numThreads = 0) const;
+    Mesh toMesh(uint32_t numThreads = 0) const;
+
+    Vec3Array& getVertices() { return mVertices; }
+    const Vec3Array& getVertices() const { return mVertices; }
+
+    std::vector<uint32_t>& getIndices() { return mIndices; }
+    const std::vector<uint32_t>& getIndices() const { return mIndices; }
+
+    Vec3Array& getNormals() { return mNormals; }
+    const Vec3Array& getNormals() const { return mNormals; }
+
+    const BoundingBox& getBoundingBox() const { return mBBox; }
+
+    void computeBoundingBox(uint32_t numThreads = 0);
+    // Computes angle weighted vertex normals. numThreads = 0 uses all the hardware threads
+    void computeNormals(uint32_t numThreads = 0);
+    VertexAdjacency computeVertexAdjacency(uint32_t numThreads = 0) const;
+    // Transforms the vertices and updates the bounding box in the same pass
+    void applyTransform(glm::mat4 trans, uint32_t numThreads = 0);
+private:
+    Vec3Array mVertices;
+    std::vector<uint32_t> mIndices;
+    Vec3Array mNormals;
+    BoundingBox mBBox;
+};
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef MESHLET_BUILDER_H
+#define MESHLET_BUILDER_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+namespace MeshletBuilder
+{
+    constexpr uint32_t MAX_VERTICES = 64;
+    constexpr uint32_t MAX_TRIANGLES = 124;
+
+    // The structs follow the std430 layout, so the arrays can be uploaded to storage buffers as they are
+    struct Meshlet
+    {
+        uint32_t vertexOffset;   // First element in MeshletData::vertices
+        uint32_t triangleOffset; // First element in MeshletData::triangles
+        uint32_t numVertices;
+        uint32_t numTriangles;
+    };
+
+    struct MeshletBounds
+    {
+        glm::vec3 center;
+        float radius;
+        // Backface culling cone: the whole meshlet faces away from a camera at position p when
+        // dot(normalize(coneApex - p), coneAxis) >= coneCutoff. A cutoff of 1 means it cannot be culled
+        glm::vec3 coneApex;
+        float padding;
+        glm::vec3 coneAxis;
+        float coneCutoff;
+    };
+
+    static_assert(sizeof(Meshlet) == 16, "Meshlet must match the std430 layout");
+    static_assert(sizeof(MeshletBounds) == 48, "MeshletBounds must match the std430 layout");
+
+    struct MeshletData
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshletBounds> bounds;
+        std::vector<uint32_t> vertices;  // Mesh vertex index of each meshlet vertex
+        std::vector<uint32_t> triangles; // Three 8 bit meshlet vertex indices packed per triangle
+    };
+
+    // Groups the triangles into meshlets, growing each one through the triangles adjacent to the last
+    // added one. Works best after MeshOptimizer::optimizeVertexCache. Both limits are at most 256
+    MeshletData buildMeshlets(const Mesh& mesh, uint32_t maxVertices = MAX_VERTICES,
+                              uint32_t maxTriangles = MAX_TRIANGLES, uint32_t numThreads = 0);
+
+    // Builds the meshlets of each mesh in parallel
+    std::vector<MeshletData> buildMeshlets(const std::vector<const Mesh*>& meshes, uint32_t maxVertices = MAX_VERTICES,
+                                           uint32_t maxTriangles = MAX_TRIANGLES, uint32_t numThreads = 0);
+
+    inline uint32_t packTriangle(uint32_t a, uint32_t b, uint32_t c) { return a | (b << 8) | (c << 16); }
+    inline glm::uvec3 unpackTriangle(uint32_t t) { return glm::uvec3(t & 0xff, (t >> 8) & 0xff, (t >> 16) & 0xff); }
+}
+
+}
+
+#endif
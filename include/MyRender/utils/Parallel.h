@@ -0,0 +1,57 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace myrender
+{
+
+namespace Parallel
+{
+    // Returns the number of threads to use. A request of 0 means all the hardware threads.
+    inline uint32_t getNumThreads(uint32_t requested = 0)
+    {
+        if(requested > 0) return requested;
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Splits [begin, end) in contiguous chunks and calls func(chunkBegin, chunkEnd, chunkId) for each one.
+    // The chunkId is always lower than getNumThreads(numThreads), so it can index per thread storage.
+    // The first chunk runs in the calling thread. Ranges smaller than minChunkSize are not split.
+    template<typename F>
+    void forRange(size_t begin, size_t end, F&& func, uint32_t numThreads = 0, size_t minChunkSize = 4096)
+    {
+        if(end <= begin) return;
+        const size_t size = end - begin;
+        const size_t maxChunks = std::max<size_t>(1, size / std::max<size_t>(1, minChunkSize));
+        const uint32_t numChunks = static_cast<uint32_t>(std::min<size_t>(getNumThreads(numThreads), maxChunks));
+
+        if(numChunks <= 1)
+        {
+            func(begin, end, 0u);
+            return;
+        }
+
+        const size_t chunkSize = (size + numChunks - 1) / numChunks;
+        std::vector<std::thread> threads;
+        threads.reserve(numChunks - 1);
+        for(uint32_t c = 1; c < numChunks; c++)
+        {
+            const size_t cBegin = begin + c * chunkSize;
+            const size_t cEnd = std::min(end, cBegin + chunkSize);
+            if(cBegin >= cEnd) break;
+            threads.emplace_back([&func, cBegin, cEnd, c]() { func(cBegin, cEnd, c); });
+        }
+
+        func(begin, std::min(end, begin + chunkSize), 0u);
+
+        for(std::thread& t : threads) t.join();
+    }
+}
+
+}
+
+#endif
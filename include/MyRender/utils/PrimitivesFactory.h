@@ -2,6 +2,7 @@
 #define PRIMITIVES_FACTORY_H
 
 #include <memory>
+#include <array>
 #include "MyRender/utils/Mesh.h"
 
 namespace myrender
@@ -12,6 +13,91 @@ namespace PrimitivesFactory
     std::shared_ptr<Mesh> getIsosphere(uint32_t subdivisions = 0);
     std::shared_ptr<Mesh> getPlane();
     std::shared_ptr<Mesh> getCube();
+
+    enum class PrimitiveType : uint32_t
+    {
+        ISOSPHERE,
+        PLANE,
+        CUBE,
+        // Analytic primitives, see write
+        CYLINDER,
+        CONE,
+        TORUS,
+        CAPSULE,
+        GRID,
+        UV_SPHERE
+    };
+
+    // Generator and its parameters, which identify the mesh it creates. Unused parameters are zero
+    struct PrimitiveDesc
+    {
+        PrimitiveType type;
+        std::array<float, 4> parameters = {0.0f, 0.0f, 0.0f, 0.0f};
+
+        bool operator<(const PrimitiveDesc& other) const
+        {
+            return type != other.type ? type < other.type : parameters < other.parameters;
+        }
+        bool operator==(const PrimitiveDesc& other) const { return type == other.type && parameters == other.parameters; }
+
+        static PrimitiveDesc isosphere(uint32_t subdivisions = 0)
+        {
+            return {PrimitiveType::ISOSPHERE, {static_cast<float>(subdivisions), 0.0f, 0.0f, 0.0f}};
+        }
+        static PrimitiveDesc plane() { return {PrimitiveType::PLANE}; }
+        static PrimitiveDesc cube() { return {PrimitiveType::CUBE}; }
+        static PrimitiveDesc cylinder(uint32_t segments = 32, float radius = 0.5f, float height = 1.0f)
+        {
+            return {PrimitiveType::CYLINDER, {static_cast<float>(segments), radius, height, 0.0f}};
+        }
+        static PrimitiveDesc cone(uint32_t segments = 32, float radius = 0.5f, float height = 1.0f)
+        {
+            return {PrimitiveType::CONE, {static_cast<float>(segments), radius, height, 0.0f}};
+        }
+        static PrimitiveDesc torus(uint32_t majorSegments = 48, uint32_t minorSegments = 24, float majorRadius = 0.375f, float minorRadius = 0.125f)
+        {
+            return {PrimitiveType::TORUS, {static_cast<float>(majorSegments), static_cast<float>(minorSegments), majorRadius, minorRadius}};
+        }
+        // height is the length of the cylinder between the two hemispheres, which have rings bands each
+        static PrimitiveDesc capsule(uint32_t segments = 32, uint32_t rings = 8, float radius = 0.25f, float height = 0.5f)
+        {
+            return {PrimitiveType::CAPSULE, {static_cast<float>(segments), static_cast<float>(rings), radius, height}};
+        }
+        // columns x rows quads covering the same square as the plane
+        static PrimitiveDesc grid(uint32_t columns, uint32_t rows)
+        {
+            return {PrimitiveType::GRID, {static_cast<float>(columns), static_cast<float>(rows), 0.0f, 0.0f}};
+        }
+        static PrimitiveDesc uvSphere(uint32_t segments = 32, uint32_t rings = 16, float radius = 0.5f)
+        {
+            return {PrimitiveType::UV_SPHERE, {static_cast<float>(segments), static_cast<float>(rings), radius, 0.0f}};
+        }
+    };
+
+    // Calls the generator of the description
+    std::shared_ptr<Mesh> create(const PrimitiveDesc& desc);
+
+    // Element of the interleaved vertex buffer of the analytic primitives
+    struct PrimitiveVertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+
+    struct PrimitiveSize
+    {
+        uint32_t numVertices = 0;
+        uint32_t numIndices = 0;
+    };
+
+    // The analytic primitives are centered at the origin with y up, except the grid which lies in the xy plane
+    // like the plane. Their normals are exact, and vertices are duplicated only along hard edges
+    bool isAnalytic(PrimitiveType type);
+    // Exact number of vertices and indices written by write, zero for the other primitives
+    PrimitiveSize getSize(const PrimitiveDesc& desc);
+    // Writes the triangles counter clockwise seen from outside. Returns false if the primitive is not analytic
+    bool write(const PrimitiveDesc& desc, PrimitiveVertex* vertices, uint32_t* indices);
+    BoundingBox getBoundingBox(const PrimitiveDesc& desc);
 }
 
 }
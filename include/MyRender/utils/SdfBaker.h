@@ -0,0 +1,79 @@
+#ifndef SDF_BAKER_H
+#define SDF_BAKER_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+// Signed distances sampled at the points origin + voxelSize * (x, y, z) of a regular grid,
+// negative inside the mesh. The values are stored with x varying fastest, then y, then z
+struct SdfGrid
+{
+    glm::uvec3 resolution = glm::uvec3(0);
+    glm::vec3 origin = glm::vec3(0.0f);
+    float voxelSize = 0.0f;
+    std::vector<float> values;
+
+    size_t getIndex(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        return (static_cast<size_t>(z) * resolution.y + y) * resolution.x + x;
+    }
+
+    float getValue(uint32_t x, uint32_t y, uint32_t z) const { return values[getIndex(x, y, z)]; }
+
+    glm::vec3 getPosition(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        return origin + voxelSize * glm::vec3(x, y, z);
+    }
+
+    BoundingBox getBoundingBox() const
+    {
+        return BoundingBox(origin, origin + voxelSize * glm::vec3(glm::max(resolution, glm::uvec3(1)) - glm::uvec3(1)));
+    }
+
+    // Trilinear interpolation, points outside the grid are clamped to it
+    float sample(const glm::vec3& point) const;
+};
+
+namespace SdfBaker
+{
+    enum class SignMethod
+    {
+        WINDING_NUMBER, // Generalized winding number, also works on meshes with holes or self intersections
+        RAY_PARITY      // Crossings of a ray along x for each row, needs a closed mesh but is faster
+    };
+
+    // Samples the signed distance of the mesh over its bounding box grown by marginRatio times its largest size.
+    // The voxels are cubes, resolution is the number of samples along the largest axis. The slices along z are
+    // computed in parallel, the distances with nearest triangle queries of a MeshBVH
+    SdfGrid bake(const Mesh& mesh, uint32_t resolution, float marginRatio = 0.05f,
+                 SignMethod signMethod = SignMethod::WINDING_NUMBER, uint32_t numThreads = 0);
+
+    // Binary .mrsdf file, a header followed by the values at a 64 bytes aligned offset so they can be
+    // used in place from a memory mapping. Little endian only
+    constexpr uint32_t MAGIC = 0x4453524d; // "MRSD" in the file
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t DATA_ALIGNMENT = 64;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t resolution[3];
+        float origin[3];
+        float voxelSize;
+        uint32_t padding;
+        uint64_t dataOffset;
+    };
+
+    bool write(const std::string& path, const SdfGrid& grid);
+    bool read(const std::string& path, SdfGrid& grid);
+}
+
+}
+
+#endif
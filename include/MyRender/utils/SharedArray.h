@@ -0,0 +1,54 @@
+#ifndef SHARED_ARRAY_H
+#define SHARED_ARRAY_H
+
+#include <memory>
+#include <vector>
+
+namespace myrender
+{
+
+// Reference counted array with copy on write. Copies share the elements until one of them is modified,
+// so copying a large array is free while nobody writes to it. Like std::vector, a single SharedArray
+// must not be modified from several threads, but copies sharing the elements can be used in different ones
+template<typename T>
+class SharedArray
+{
+public:
+    SharedArray() {}
+
+    const std::vector<T>& get() const { return mData != nullptr ? *mData : getEmpty(); }
+
+    // Array to modify, copied first if other SharedArray use it
+    std::vector<T>& edit()
+    {
+        if(mData == nullptr) mData = std::make_shared<std::vector<T>>();
+        else if(mData.use_count() > 1) mData = std::make_shared<std::vector<T>>(*mData);
+        return *mData;
+    }
+
+    // Array to overwrite completely. If it is shared it is replaced by an empty one instead of being copied
+    std::vector<T>& rewrite()
+    {
+        if(mData == nullptr || mData.use_count() > 1) mData = std::make_shared<std::vector<T>>();
+        return *mData;
+    }
+
+    // Drops the reference to the elements, which are freed with the last one
+    void release() { mData.reset(); }
+
+    bool isShared() const { return mData != nullptr && mData.use_count() > 1; }
+    size_t size() const { return get().size(); }
+
+private:
+    std::shared_ptr<std::vector<T>> mData;
+
+    static const std::vector<T>& getEmpty()
+    {
+        static const std::vector<T> empty;
+        return empty;
+    }
+};
+
+}
+
+#endif
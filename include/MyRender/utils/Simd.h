@@ -0,0 +1,29 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+namespace myrender
+{
+
+namespace Simd
+{
+    enum class Level
+    {
+        SCALAR,
+        SSE,
+        AVX2
+    };
+
+    // Best instruction set supported by the current CPU
+    Level getSupportedLevel();
+
+    // Instruction set used by the geometry kernels. By default it is the supported one
+    Level getLevel();
+    // Limits the instruction set used by the kernels, it is clamped to the supported level
+    void setLevel(Level level);
+
+    const char* getLevelName(Level level);
+}
+
+}
+
+#endif
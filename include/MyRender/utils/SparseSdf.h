@@ -0,0 +1,92 @@
+#ifndef SPARSE_SDF_H
+#define SPARSE_SDF_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+class Shader;
+
+// Two level signed distance field. A coarse grid of cells of (BRICK_SIZE - 1) voxels covers the whole volume
+// and stores the distances at the cell corners. Only the cells the surface may cross are refined with a brick
+// of BRICK_SIZE^3 samples, which includes the cell faces so each brick can be interpolated on its own.
+// Brick samples are quantized to 16 bits in [-mBrickRange, mBrickRange]. Distances are negative inside
+class SparseSdf
+{
+public:
+    static constexpr uint32_t BRICK_SIZE = 8;
+    static constexpr uint32_t BRICK_SAMPLES = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+    static constexpr uint32_t NO_BRICK = ~0u;
+
+    // Layout of the buffer returned by getGpuData, all the offsets are in 32 bit words from its start.
+    // Brick samples are packed two per word, the first one in the low bits
+    struct GpuHeader
+    {
+        uint32_t numCells[3];
+        uint32_t numBricks;
+        float origin[3];
+        float voxelSize;
+        float brickRange;
+        uint32_t coarseValuesOffset; // float per coarse corner, x fastest
+        uint32_t brickIndicesOffset; // uint per cell, x fastest, NO_BRICK when it has none
+        uint32_t brickDataOffset;    // BRICK_SAMPLES / 2 words per brick
+    };
+
+    // .mrssdf files are a magic number and a version followed by the GPU buffer
+    static constexpr uint32_t MAGIC = 0x5353524d; // "MRSS" in the file
+    static constexpr uint32_t VERSION = 1;
+
+    SparseSdf() {}
+
+    // resolution is the number of fine samples along the largest axis of the bounding box grown by marginRatio
+    // times its largest size, as in SdfBaker::bake. Bricks are computed in parallel, the sign comes from
+    // the generalized winding number
+    void build(const Mesh& mesh, uint32_t resolution, float marginRatio = 0.05f, uint32_t numThreads = 0);
+
+    // Trilinear interpolation of the brick holding the point, or of the coarse cell if it has none.
+    // Points outside the volume are clamped to it
+    float sample(const glm::vec3& point) const;
+
+    const glm::uvec3& getNumCells() const { return mNumCells; }
+    uint32_t getNumBricks() const { return static_cast<uint32_t>(mBrickData.size() / BRICK_SAMPLES); }
+    float getVoxelSize() const { return mVoxelSize; }
+    BoundingBox getBoundingBox() const
+    {
+        return BoundingBox(mOrigin, mOrigin + static_cast<float>(BRICK_SIZE - 1) * mVoxelSize * glm::vec3(mNumCells));
+    }
+    // Bytes used by the coarse grid, the brick indices and the bricks
+    size_t getMemorySize() const;
+
+    void getGpuData(std::vector<uint32_t>& data) const;
+    // Uploads getGpuData to the shader storage buffer bufferName, see shaders/SparseSdf.glsl for its evaluation
+    bool upload(Shader& shader, const std::string& bufferName) const;
+
+    bool write(const std::string& path) const;
+    bool read(const std::string& path);
+
+private:
+    glm::uvec3 mNumCells = glm::uvec3(0);
+    glm::vec3 mOrigin = glm::vec3(0.0f);
+    float mVoxelSize = 0.0f;
+    float mBrickRange = 0.0f;
+    std::vector<float> mCoarseValues;
+    std::vector<uint32_t> mBrickIndices;
+    std::vector<uint16_t> mBrickData;
+
+    size_t getCellIndex(const glm::uvec3& cell) const { return (static_cast<size_t>(cell.z) * mNumCells.y + cell.y) * mNumCells.x + cell.x; }
+    float getCoarseValue(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        return mCoarseValues[(static_cast<size_t>(z) * (mNumCells.y + 1) + y) * (mNumCells.x + 1) + x];
+    }
+    float decode(uint16_t value) const { return mBrickRange * (static_cast<float>(value) / 32767.5f - 1.0f); }
+    uint16_t encode(float distance) const;
+    bool setGpuData(const uint32_t* data, size_t numWords);
+};
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef VERTEX_QUANTIZATION_H
+#define VERTEX_QUANTIZATION_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+// Compact vertex attributes uploaded by RenderMesh when the vertex quantization is enabled.
+// The built-in shaders decode them with the positionOffset, positionScale and octahedralNormals uniforms
+namespace VertexQuantization
+{
+    // Position normalized to the bounding box as unorm16, padded to keep the attribute 4 byte aligned
+    struct QuantizedPosition
+    {
+        uint16_t x, y, z, padding;
+    };
+
+    // Unit vector in octahedral encoding as snorm16
+    struct QuantizedNormal
+    {
+        int16_t x, y;
+    };
+
+    inline QuantizedPosition encodePosition(const glm::vec3& position, const BoundingBox& box)
+    {
+        const glm::vec3 size = box.getSize();
+        const glm::vec3 invSize(size.x > 0.0f ? 1.0f / size.x : 0.0f,
+                                size.y > 0.0f ? 1.0f / size.y : 0.0f,
+                                size.z > 0.0f ? 1.0f / size.z : 0.0f);
+        const glm::vec3 q = glm::clamp((position - box.min) * invSize, 0.0f, 1.0f) * 65535.0f + 0.5f;
+        return {static_cast<uint16_t>(q.x), static_cast<uint16_t>(q.y), static_cast<uint16_t>(q.z), 0};
+    }
+
+    inline glm::vec3 decodePosition(const QuantizedPosition& position, const BoundingBox& box)
+    {
+        return box.min + box.getSize() * glm::vec3(position.x, position.y, position.z) / 65535.0f;
+    }
+
+    inline QuantizedNormal encodeNormal(const glm::vec3& normal)
+    {
+        // Project on the octahedron and fold the lower half over the upper one
+        const glm::vec3 n = normal / (glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z));
+        glm::vec2 e(n.x, n.y);
+        if(n.z < 0.0f)
+        {
+            e = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        e = glm::round(glm::clamp(e, -1.0f, 1.0f) * 32767.0f);
+        return {static_cast<int16_t>(e.x), static_cast<int16_t>(e.y)};
+    }
+
+    inline glm::vec3 decodeNormal(const QuantizedNormal& normal)
+    {
+        const glm::vec2 e = glm::max(glm::vec2(normal.x, normal.y) / 32767.0f, -1.0f);
+        glm::vec3 n(e.x, e.y, 1.0f - glm::abs(e.x) - glm::abs(e.y));
+        if(n.z < 0.0f)
+        {
+            const glm::vec2 folded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+            n.x = folded.x;
+            n.y = folded.y;
+        }
+        return glm::normalize(n);
+    }
+}
+
+}
+
+#endif
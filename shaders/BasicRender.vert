@@ -4,9 +4,13 @@ layout (location = 0) in vec3 position;
 uniform mat4 projectionViewModelMatrix;
 uniform vec4 outColor = vec4(0.8, 0.0, 0.0, 1.0);
 
+// Quantized positions are normalized to the bounding box of the mesh
+uniform vec3 positionOffset = vec3(0.0);
+uniform vec3 positionScale = vec3(1.0);
+
 out vec4 fcolor;
 
 void main() {
-	gl_Position = projectionViewModelMatrix * vec4(position, 1.0f);
+	gl_Position = projectionViewModelMatrix * vec4(positionOffset + positionScale * position, 1.0f);
 	fcolor = outColor;
 }
@@ -5,9 +5,22 @@ layout (location = 1) in vec3 normals;
 uniform mat4 projectionViewModelMatrix;
 uniform mat3 normalModelMatrix;
 
+// Quantized positions are normalized to the bounding box of the mesh
+uniform vec3 positionOffset = vec3(0.0);
+uniform vec3 positionScale = vec3(1.0);
+// Quantized normals are two octahedral components, the third one arrives as 0
+uniform int octahedralNormals = 0;
+
 out vec3 worldSpaceNormal;
 
+vec3 decodeOctahedral(vec2 e) {
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if(n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return normalize(n);
+}
+
 void main() {
-    worldSpaceNormal = normalModelMatrix * normals;
-	gl_Position = projectionViewModelMatrix * vec4(position, 1.0f);
+	vec3 normal = (octahedralNormals != 0) ? decodeOctahedral(normals.xy) : normals;
+    worldSpaceNormal = normalModelMatrix * normal;
+	gl_Position = projectionViewModelMatrix * vec4(positionOffset + positionScale * position, 1.0f);
 }
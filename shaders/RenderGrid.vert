@@ -7,8 +7,12 @@ uniform mat4 viewModelMatrix;
 
 uniform float normalOffset = 0.0001;
 
+// Quantized positions are normalized to the bounding box of the mesh
+uniform vec3 positionOffset = vec3(0.0);
+uniform vec3 positionScale = vec3(1.0);
+
 void main() {
-	vec4 pos = viewModelMatrix * vec4(position, 1.0);
+	vec4 pos = viewModelMatrix * vec4(positionOffset + positionScale * position, 1.0);
 	pos.z += normalOffset;
 	gl_Position = projectionMatrix * pos;
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+// Evaluation of a SparseSdf uploaded with SparseSdf::upload, to be pasted in the shaders that need it.
+// The buffer layout is the one of SparseSdf::GpuHeader followed by its arrays
+
+layout(std430, binding = 0) readonly buffer SparseSdfBuffer
+{
+	uint sparseSdfData[];
+};
+
+const uint SPARSE_SDF_BRICK_SIZE = 8u;
+const uint SPARSE_SDF_NO_BRICK = 0xffffffffu;
+
+uvec3 getSparseSdfNumCells() { return uvec3(sparseSdfData[0], sparseSdfData[1], sparseSdfData[2]); }
+vec3 getSparseSdfOrigin() { return uintBitsToFloat(uvec3(sparseSdfData[4], sparseSdfData[5], sparseSdfData[6])); }
+float getSparseSdfVoxelSize() { return uintBitsToFloat(sparseSdfData[7]); }
+
+float getSparseSdfCoarseValue(uvec3 corner, uvec3 numCells)
+{
+	const uint index = (corner.z * (numCells.y + 1u) + corner.y) * (numCells.x + 1u) + corner.x;
+	return uintBitsToFloat(sparseSdfData[sparseSdfData[9] + index]);
+}
+
+float getSparseSdfBrickValue(uint brick, uvec3 voxel)
+{
+	const uint index = brick * SPARSE_SDF_BRICK_SIZE * SPARSE_SDF_BRICK_SIZE * SPARSE_SDF_BRICK_SIZE +
+					   (voxel.z * SPARSE_SDF_BRICK_SIZE + voxel.y) * SPARSE_SDF_BRICK_SIZE + voxel.x;
+	const uint word = sparseSdfData[sparseSdfData[11] + index / 2u];
+	const uint value = (index & 1u) == 0u ? (word & 0xffffu) : (word >> 16u);
+	return uintBitsToFloat(sparseSdfData[8]) * (float(value) / 32767.5 - 1.0);
+}
+
+// Signed distance at a world space point, clamped to the volume
+float sampleSparseSdf(vec3 point)
+{
+	const uvec3 numCells = getSparseSdfNumCells();
+	const float cellSize = float(SPARSE_SDF_BRICK_SIZE - 1u) * getSparseSdfVoxelSize();
+	const vec3 coord = clamp((point - getSparseSdfOrigin()) / cellSize, vec3(0.0), vec3(numCells));
+	const uvec3 cell = min(uvec3(coord), numCells - uvec3(1u));
+	const vec3 local = coord - vec3(cell);
+	const uint brick = sparseSdfData[sparseSdfData[10] + (cell.z * numCells.y + cell.y) * numCells.x + cell.x];
+
+	float c[8];
+	vec3 f;
+	if(brick == SPARSE_SDF_NO_BRICK)
+	{
+		for(uint i = 0u; i < 8u; i++) c[i] = getSparseSdfCoarseValue(cell + uvec3(i & 1u, (i >> 1u) & 1u, i >> 2u), numCells);
+		f = local;
+	}
+	else
+	{
+		const vec3 brickCoord = float(SPARSE_SDF_BRICK_SIZE - 1u) * local;
+		const uvec3 s = min(uvec3(brickCoord), uvec3(SPARSE_SDF_BRICK_SIZE - 2u));
+		for(uint i = 0u; i < 8u; i++) c[i] = getSparseSdfBrickValue(brick, s + uvec3(i & 1u, (i >> 1u) & 1u, i >> 2u));
+		f = brickCoord - vec3(s);
+	}
+	return mix(mix(mix(c[0], c[1], f.x), mix(c[2], c[3], f.x), f.y), mix(mix(c[4], c[5], f.x), mix(c[6], c[7], f.x), f.y), f.z);
+}
@@ -18,6 +18,15 @@ void Camera::resize(glm::ivec2 windowSize)
     recalculateProjectionMatrix();
 }
 
+glm::vec3 Camera::getRayDirection(glm::vec2 screenPosition) const
+{
+    const glm::vec2 windowSize = glm::vec2(Window::getCurrentWindow().getWindowSize());
+    const glm::vec2 ndc(2.0f * screenPosition.x / windowSize.x - 1.0f, 1.0f - 2.0f * screenPosition.y / windowSize.y);
+    const float tanHalfFov = glm::tan(0.5f * glm::radians(mFov));
+    const glm::vec3 viewDirection(ndc.x * tanHalfFov * mAspectRatio, ndc.y * tanHalfFov, -1.0f);
+    return glm::normalize(glm::vec3(mInverseViewMatrix * glm::vec4(viewDirection, 0.0f)));
+}
+
 void Camera::drawGui()
 {
     bool change = false;
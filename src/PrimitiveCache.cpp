@@ -0,0 +1,48 @@
+#include "MyRender/PrimitiveCache.h"
+
+namespace myrender
+{
+
+std::shared_ptr<const Mesh> PrimitiveCache::getMesh(const PrimitivesFactory::PrimitiveDesc& desc)
+{
+	auto it = mMeshes.find(desc);
+	if(it != mMeshes.end() && !it->second.expired())
+	{
+		return it->second.lock();
+	}
+
+	std::shared_ptr<Mesh> mesh = PrimitivesFactory::create(desc);
+	if(mesh->getNormals().size() != mesh->getVertices().size()) mesh->computeNormals();
+	mesh->computeBoundingBox();
+	mMeshes[desc] = mesh;
+	return mesh;
+}
+
+void PrimitiveCache::setMeshData(RenderMesh& renderMesh, const PrimitivesFactory::PrimitiveDesc& desc)
+{
+	const std::pair<PrimitivesFactory::PrimitiveDesc, bool> key(desc, renderMesh.isVertexQuantizationEnabled());
+	auto it = mBuffers.find(key);
+	if(it != mBuffers.end() && !it->second.expired())
+	{
+		renderMesh.setMeshBuffers(it->second.lock());
+		return;
+	}
+
+	// Upload into new buffers, the RenderMesh may already have data in its own
+	renderMesh.setMeshBuffers(std::make_shared<RenderMesh::MeshBuffers>());
+	renderMesh.start();
+	if(PrimitivesFactory::isAnalytic(desc.type) && !key.second)
+	{
+		renderMesh.setPrimitiveData(desc);
+	}
+	else
+	{
+		// Upload a copy, which shares the arrays of the cached mesh. If the RenderMesh releases the data
+		// after the upload only the copy drops them
+		Mesh mesh = *getMesh(desc);
+		renderMesh.setMeshData(mesh);
+	}
+	mBuffers[key] = renderMesh.getMeshBuffers();
+}
+
+}
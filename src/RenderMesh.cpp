@@ -1,48 +1,372 @@
 
 #include "MyRender/RenderMesh.h"
 #include <iostream>
+#include <algorithm>
 #include <imgui.h>
 #include "MyRender/Camera.h"
+#include "MyRender/Window.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/utils/VertexQuantization.h"
+#include "utils/MeshKernels.h"
+#include "utils/MeshNormals.h"
 
 namespace myrender
 {
 
+int getSize(GLenum type) {
+	switch (type) {
+	case GL_FLOAT:
+	case GL_UNSIGNED_INT:
+		return 4;
+	case GL_INT:
+		return 4;
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+	case GL_HALF_FLOAT:
+		return 2;
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+		return 1;
+	}
+	return 0;
+}
+
 void RenderMesh::setMeshData(Mesh& mesh)
 {
-	setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 3)}, 
-				  mesh.getVertices().data(), mesh.getVertices().size());
-	
-	if(mesh.getNormals().size() == mesh.getVertices().size())
+	unshareMeshBuffers();
+	if(mesh.getBoundingBox().min.x > mesh.getBoundingBox().max.x) mesh.computeBoundingBox();
+	mBuffers->bbox = mesh.getBoundingBox();
+	// Read through a const reference, so the arrays shared with other meshes are not copied
+	const Mesh& data = mesh;
+	resetMeshAttributes();
+
+	if(mQuantizeVertices)
+	{
+		uploadQuantizedVertices(data.getVertices(), data.getNormals());
+	}
+	else
 	{
+		mBuffers->positionOffset = glm::vec3(0.0f);
+		mBuffers->positionScale = glm::vec3(1.0f);
+		mBuffers->octahedralNormals = false;
+
 		setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 3)}, 
-				  mesh.getNormals().data(), mesh.getNormals().size());
+					  data.getVertices().data(), data.getVertices().size());
+		
+		if(data.getNormals().size() == data.getVertices().size())
+		{
+			setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 3)}, 
+					  data.getNormals().data(), data.getNormals().size());
+		}
+	}
+
+	// Each stream has its own location whichever of the others the mesh has
+	const size_t numVertices = data.getVertices().size();
+	if(data.getNormals().size() == numVertices && data.getTangents().size() == numVertices)
+	{
+		mBuffers->nextAttributeIndex = TANGENT_LOCATION;
+		setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 4)}, 
+					  data.getTangents().data(), numVertices);
+	}
+	if(data.getTexCoords().size() == numVertices)
+	{
+		mBuffers->nextAttributeIndex = TEXCOORD_LOCATION;
+		setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 2)}, 
+					  data.getTexCoords().data(), numVertices);
+	}
+
+	setIndexData(data.getIndices().data(), data.getIndices().size());
+
+	if(mReleaseMeshData) mesh.releaseData();
+}
+
+void RenderMesh::setMeshData(MeshSoA& mesh)
+{
+	unshareMeshBuffers();
+	if(mesh.getBoundingBox().min.x > mesh.getBoundingBox().max.x) mesh.computeBoundingBox();
+	mBuffers->bbox = mesh.getBoundingBox();
+	resetMeshAttributes();
+
+	if(mQuantizeVertices)
+	{
+		uploadQuantizedVertices(mesh.getVertices(), mesh.getNormals());
+		setIndexData(mesh.getIndices());
+		return;
+	}
+
+	mBuffers->positionOffset = glm::vec3(0.0f);
+	mBuffers->positionScale = glm::vec3(1.0f);
+	mBuffers->octahedralNormals = false;
+
+	uploadVec3Array(mesh.getVertices());
+
+	if(mesh.getNormals().size() == mesh.getVertices().size())
+	{
+		uploadVec3Array(mesh.getNormals());
 	}
 
 	setIndexData(mesh.getIndices());
 }
 
-RenderMesh::~RenderMesh()
+void RenderMesh::setMeshData(const MappedMesh& mesh)
+{
+	unshareMeshBuffers();
+	mBuffers->bbox = mesh.getBoundingBox();
+	if(mBuffers->bbox.min.x > mBuffers->bbox.max.x)
+	{
+		// Files written before the bounds were always computed can store an empty box
+		std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(0));
+		Parallel::forRange(0, mesh.getNumVertices(), [&](size_t begin, size_t end, uint32_t chunkId)
+		{
+			chunkBoxes[chunkId] = internal::computeBoundingBox(mesh.getVertices() + begin, end - begin);
+		}, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+		for(const BoundingBox& chunkBox : chunkBoxes) mBuffers->bbox.addBoundingBox(chunkBox);
+	}
+	resetMeshAttributes();
+
+	if(mQuantizeVertices)
+	{
+		const internal::Vec3View vertices = {mesh.getVertices(), mesh.getNumVertices()};
+		const internal::Vec3View normals = {mesh.getNormals(), mesh.getNormals() != nullptr ? mesh.getNumVertices() : 0};
+		uploadQuantizedVertices(vertices, normals);
+	}
+	else
+	{
+		mBuffers->positionOffset = glm::vec3(0.0f);
+		mBuffers->positionScale = glm::vec3(1.0f);
+		mBuffers->octahedralNormals = false;
+
+		setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 3)}, 
+					  mesh.getVertices(), mesh.getNumVertices());
+
+		if(mesh.getNormals() != nullptr)
+		{
+			setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 3)}, 
+						  mesh.getNormals(), mesh.getNumVertices());
+		}
+	}
+
+	// All the levels are already contiguous in the file
+	setIndexData(mesh.getAllIndices(), mesh.getNumAllIndices());
+	for(const MeshFile::LodRange& lod : mesh.getLods())
+	{
+		mBuffers->lods.push_back({static_cast<size_t>(lod.firstIndex), static_cast<size_t>(lod.numIndices), lod.error});
+	}
+	if(!mBuffers->lods.empty()) mBuffers->indexArraySize = mBuffers->lods[0].numIndices;
+}
+
+void RenderMesh::setPrimitiveData(const PrimitivesFactory::PrimitiveDesc& desc)
+{
+	if(!PrimitivesFactory::isAnalytic(desc.type))
+	{
+		std::cout << "Error: the primitive has no interleaved layout" << std::endl;
+		return;
+	}
+
+	unshareMeshBuffers();
+	mBuffers->bbox = PrimitivesFactory::getBoundingBox(desc);
+	resetMeshAttributes();
+	mBuffers->positionOffset = glm::vec3(0.0f);
+	mBuffers->positionScale = glm::vec3(1.0f);
+	mBuffers->octahedralNormals = false;
+
+	// Same attributes as setMeshData, from a single buffer
+	const PrimitivesFactory::PrimitiveSize size = PrimitivesFactory::getSize(desc);
+	const uint32_t bufferId = setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 3), RenderMesh::VertexParameterLayout(GL_FLOAT, 3)}, 
+											nullptr, size.numVertices);
+	void* vertices = mapVertexBuffer(bufferId, size.numVertices * sizeof(PrimitivesFactory::PrimitiveVertex));
+	if(vertices == nullptr) return;
+	std::vector<unsigned int> indices(size.numIndices);
+	PrimitivesFactory::write(desc, reinterpret_cast<PrimitivesFactory::PrimitiveVertex*>(vertices), indices.data());
+	unmapVertexBuffer();
+
+	setIndexData(indices);
+}
+
+void RenderMesh::setLods(const std::vector<MeshSimplifier::MeshLod>& lods)
 {
-    glDeleteVertexArrays(1, &mVAO);
-	for(BufferData& b : mBuffersData)
+	std::vector<unsigned int> indices;
+	std::vector<LodRange> ranges;
+	for(const MeshSimplifier::MeshLod& lod : lods)
+	{
+		ranges.push_back({indices.size(), lod.indices.size(), lod.error});
+		indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+	}
+
+	setIndexData(indices);
+	mBuffers->lods = std::move(ranges);
+	mCurrentLod = 0;
+	if(!mBuffers->lods.empty()) mBuffers->indexArraySize = mBuffers->lods[0].numIndices;
+}
+
+uint32_t RenderMesh::selectLod(Camera* camera) const
+{
+	if(mBuffers->lods.size() <= 1 || camera == nullptr) return 0;
+
+	// Bounding sphere of the box in world space
+	const glm::vec3 center = glm::vec3(mTransform * glm::vec4(mBuffers->bbox.getCenter(), 1.0f));
+	const float scale = glm::max(glm::length(glm::vec3(mTransform[0])),
+								 glm::max(glm::length(glm::vec3(mTransform[1])), glm::length(glm::vec3(mTransform[2]))));
+	const float radius = 0.5f * glm::length(mBuffers->bbox.getSize()) * scale;
+	const float distance = glm::length(center - glm::vec3(camera->getInverseViewMatrix()[3]));
+	if(distance <= radius) return 0;
+
+	// Projected size of the largest side of the box, the unit of the lod errors
+	const float viewportHeight = static_cast<float>(Window::getCurrentWindow().getWindowSize().y);
+	const float pixelsPerUnit = 0.5f * viewportHeight * camera->getProjectionMatrix()[1][1] / (distance - radius);
+	const glm::vec3 size = mBuffers->bbox.getSize();
+	const float projectedSize = glm::max(size.x, glm::max(size.y, size.z)) * scale * pixelsPerUnit;
+
+	for(uint32_t lod = static_cast<uint32_t>(mBuffers->lods.size()) - 1; lod > 0; lod--)
+	{
+		if(mBuffers->lods[lod].error * projectedSize <= mLodThreshold) return lod;
+	}
+	return 0;
+}
+
+void RenderMesh::uploadVec3Array(const Vec3Array& array)
+{
+	// A vec3 attribute cannot be sourced from three separate arrays, so the components are
+	// interleaved while writing them into the mapped buffer, without any intermediate copy
+	const uint32_t bufferId = setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_FLOAT, 3)}, 
+											nullptr, array.size());
+	if(array.size() == 0) return;
+
+	void* data = mapVertexBuffer(bufferId, array.size() * sizeof(glm::vec3));
+	if(data == nullptr) return;
+	array.copyTo(reinterpret_cast<glm::vec3*>(data));
+	unmapVertexBuffer();
+}
+
+void* RenderMesh::mapVertexBuffer(uint32_t bufferId, size_t numBytes)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, mBuffers->buffersData[bufferId].VBO);
+	void* data = glMapBufferRange(GL_ARRAY_BUFFER, 0, numBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if(data == nullptr)
+	{
+		std::cout << "Error: vertex buffer could not be mapped" << std::endl;
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	return data;
+}
+
+void RenderMesh::unmapVertexBuffer()
+{
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+template<typename VertexArray, typename NormalArray>
+void RenderMesh::uploadQuantizedVertices(const VertexArray& vertices, const NormalArray& normals)
+{
+	using namespace VertexQuantization;
+	const size_t numVertices = vertices.size();
+
+	// The bounds come from the uploaded vertices rather than from the mesh or the file, which can be stale,
+	// since the positions out of them would be clamped
+	std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(0));
+	Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t chunkId)
+	{
+		for(size_t i = begin; i < end; i++) chunkBoxes[chunkId].addPoint(internal::loadVec3(vertices, i));
+	}, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+	BoundingBox box;
+	for(const BoundingBox& chunkBox : chunkBoxes) box.addBoundingBox(chunkBox);
+	if(numVertices > 0) mBuffers->bbox = box;
+
+	mBuffers->positionOffset = box.min;
+	mBuffers->positionScale = box.getSize();
+	mBuffers->octahedralNormals = normals.size() == numVertices;
+
+	const uint32_t positionsId = setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_UNSIGNED_SHORT, 4, true)}, 
+											   nullptr, numVertices);
+	if(numVertices == 0) return;
+
+	QuantizedPosition* positions = reinterpret_cast<QuantizedPosition*>(mapVertexBuffer(positionsId, numVertices * sizeof(QuantizedPosition)));
+	if(positions != nullptr)
+	{
+		Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+		{
+			for(size_t i = begin; i < end; i++) positions[i] = encodePosition(internal::loadVec3(vertices, i), box);
+		}, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+		unmapVertexBuffer();
+	}
+
+	if(!mBuffers->octahedralNormals) return;
+
+	const uint32_t normalsId = setVertexData(std::vector<RenderMesh::VertexParameterLayout> {RenderMesh::VertexParameterLayout(GL_SHORT, 2, true)}, 
+											 nullptr, numVertices);
+	QuantizedNormal* quantizedNormals = reinterpret_cast<QuantizedNormal*>(mapVertexBuffer(normalsId, numVertices * sizeof(QuantizedNormal)));
+	if(quantizedNormals != nullptr)
+	{
+		Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+		{
+			for(size_t i = begin; i < end; i++) quantizedNormals[i] = encodeNormal(internal::loadVec3(normals, i));
+		}, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+		unmapVertexBuffer();
+	}
+}
+
+void RenderMesh::setVertexDecodingUniforms(Shader& shader)
+{
+	shader.setUniform("positionOffset", mBuffers->positionOffset);
+	shader.setUniform("positionScale", mBuffers->positionScale);
+	int octahedralNormals = mBuffers->octahedralNormals ? 1 : 0;
+	shader.setUniform("octahedralNormals", octahedralNormals);
+}
+
+RenderMesh::MeshBuffers::~MeshBuffers()
+{
+	if(VAO != 0) glDeleteVertexArrays(1, &VAO);
+	for(BufferData& b : buffersData)
 	{
 		glDeleteBuffers(1, &b.VBO);
 	}
-	if(mHasElementBuffer) glDeleteBuffers(1, &mEBO);
+	if(hasElementBuffer) glDeleteBuffers(1, &EBO);
+}
+
+void RenderMesh::unshareMeshBuffers()
+{
+	if(mBuffers.use_count() <= 1) return;
+	const GLenum format = mBuffers->format;
+	mBuffers = std::make_shared<MeshBuffers>();
+	mBuffers->format = format;
+	mCurrentLod = 0;
+	start();
+}
+
+void RenderMesh::resetMeshAttributes()
+{
+	// Buffers of a previous setMeshData stay in the vertex array, so the locations it used are disabled
+	// until this upload enables them again
+	glBindVertexArray(mBuffers->VAO);
+	for(uint32_t location = POSITION_LOCATION; location <= TEXCOORD_LOCATION; location++) glDisableVertexAttribArray(location);
+	glBindVertexArray(0);
+	mBuffers->nextAttributeIndex = POSITION_LOCATION;
 }
 
 void RenderMesh::start()
 {
-    glGenVertexArrays(1, &mVAO);
-	glBindVertexArray(mVAO);
+	if(mBuffers->VAO != 0) return;
+    glGenVertexArrays(1, &mBuffers->VAO);
+	glBindVertexArray(mBuffers->VAO);
 	glBindVertexArray(0);
 }
 
 void RenderMesh::draw(Camera* camera)
 {
-    if (!mMeshAllocated) return;
+    if (!mBuffers->allocated) return;
 
-	glBindVertexArray(mVAO);
+	glBindVertexArray(mBuffers->VAO);
+
+	size_t firstIndex = 0;
+	size_t numIndices = mBuffers->indexArraySize;
+	if(!mBuffers->lods.empty())
+	{
+		mCurrentLod = selectLod(camera);
+		firstIndex = mBuffers->lods[mCurrentLod].firstIndex;
+		numIndices = mBuffers->lods[mCurrentLod].numIndices;
+	}
+	const void* indexOffset = reinterpret_cast<void*>(firstIndex * getSize(mBuffers->indexType));
 
 	if (mPrintSurface) {
 		if(mShader == nullptr)
@@ -51,17 +375,18 @@ void RenderMesh::draw(Camera* camera)
 			mShader->load("BasicRender");
 		}
 		mShader->bind(camera, &mTransform);
+		setVertexDecodingUniforms(*mShader);
 
 		//draw
 		if (mDrawMode != GL_FILL) glPolygonMode(GL_FRONT_AND_BACK, mDrawMode);
 		
-		if(mHasElementBuffer)
+		if(mBuffers->hasElementBuffer)
 		{
-			glDrawElements(mFormat, mIndexArraySize, GL_UNSIGNED_INT, 0);
+			glDrawElements(mBuffers->format, numIndices, mBuffers->indexType, indexOffset);
 		}
 		else
 		{
-			glDrawArrays(mFormat, 0, mDataArraySize);
+			glDrawArrays(mBuffers->format, 0, mBuffers->dataArraySize);
 		}
 
 		if (mDrawMode != GL_FILL) glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -79,18 +404,19 @@ void RenderMesh::draw(Camera* camera)
 		glLineWidth(3);
 
 		mGridShader->bind(camera, &mTransform);
+		setVertexDecodingUniforms(*mGridShader);
 
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
 		glDepthFunc(GL_LEQUAL);
 
-		if(mHasElementBuffer)
+		if(mBuffers->hasElementBuffer)
 		{
-			glDrawElements(mFormat, mIndexArraySize, GL_UNSIGNED_INT, 0);
+			glDrawElements(mBuffers->format, numIndices, mBuffers->indexType, indexOffset);
 		}
 		else
 		{
-			glDrawArrays(mFormat, 0, mDataArraySize);
+			glDrawArrays(mBuffers->format, 0, mBuffers->dataArraySize);
 		}
 
 		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -108,22 +434,19 @@ void RenderMesh::drawGui()
 	ImGui::Text((systemName == "") ? "RenderMesh" : systemName.c_str());
     ImGui::Checkbox("Draw Wireframe", &mPrintWireframe);
 	ImGui::Checkbox("Draw Surface", &mPrintSurface);
-}
-
-int getSize(GLenum type) {
-	switch (type) {
-	case GL_FLOAT:
-		return 4;
+	if(!mBuffers->lods.empty())
+	{
+		ImGui::Text("LOD %u / %u, %u triangles", mCurrentLod, static_cast<uint32_t>(mBuffers->lods.size() - 1),
+					static_cast<uint32_t>(mBuffers->lods[mCurrentLod].numIndices / 3));
+		ImGui::SliderFloat("LOD threshold (px)", &mLodThreshold, 0.0f, 10.0f);
 	}
-	return 0;
 }
 
-
-uint32_t RenderMesh::setVertexData(std::vector<VertexParameterLayout> parameters, void* data, size_t numElements)
+uint32_t RenderMesh::setVertexData(std::vector<VertexParameterLayout> parameters, const void* data, size_t numElements)
 {
-	mDataArraySize = numElements;
+	mBuffers->dataArraySize = numElements;
 
-	glBindVertexArray(mVAO);
+	glBindVertexArray(mBuffers->VAO);
 	unsigned int VBO;
 	glGenBuffers(1, &VBO);
 
@@ -134,7 +457,7 @@ uint32_t RenderMesh::setVertexData(std::vector<VertexParameterLayout> parameters
 		stripSize += parameter.size * getSize(parameter.type);
 	}
 
-	mBuffersData.push_back(BufferData(VBO, stripSize));
+	mBuffers->buffersData.push_back(BufferData(VBO, stripSize));
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, numElements * stripSize, data, GL_STATIC_DRAW);
@@ -142,26 +465,26 @@ uint32_t RenderMesh::setVertexData(std::vector<VertexParameterLayout> parameters
 	// Set the vertex parameters
 	int currentSize = 0;
 	for (uint32_t i = 0; i < parameters.size(); i++) {
-		glVertexAttribPointer(mNextAttributeIndex, parameters[i].size, parameters[i].type, GL_FALSE, stripSize, reinterpret_cast<void*>(static_cast<size_t>(currentSize)));
-		glEnableVertexAttribArray(mNextAttributeIndex++);
+		glVertexAttribPointer(mBuffers->nextAttributeIndex, parameters[i].size, parameters[i].type, parameters[i].normalized ? GL_TRUE : GL_FALSE, stripSize, reinterpret_cast<void*>(static_cast<size_t>(currentSize)));
+		glEnableVertexAttribArray(mBuffers->nextAttributeIndex++);
 		currentSize += parameters[i].size * getSize(parameters[i].type);
 	}
 
 	glBindVertexArray(0);
 
-	mMeshAllocated = true;
+	mBuffers->allocated = true;
 
-	return mBuffersData.size() - 1;
+	return mBuffers->buffersData.size() - 1;
 }
 
-void RenderMesh::setVertexData(uint32_t bufferId, void* data, size_t numElements)
+void RenderMesh::setVertexData(uint32_t bufferId, const void* data, size_t numElements)
 {
-	mDataArraySize = numElements;
+	mBuffers->dataArraySize = numElements;
 
-	glBindVertexArray(mVAO);
+	glBindVertexArray(mBuffers->VAO);
 
-	glBindBuffer(GL_ARRAY_BUFFER, mBuffersData[bufferId].VBO);
-	glBufferData(GL_ARRAY_BUFFER, numElements * mBuffersData[bufferId].elementsSize, data, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, mBuffers->buffersData[bufferId].VBO);
+	glBufferData(GL_ARRAY_BUFFER, numElements * mBuffers->buffersData[bufferId].elementsSize, data, GL_STATIC_DRAW);
 
 	glBindVertexArray(0);
 }
@@ -171,26 +494,62 @@ void RenderMesh::setIndexData(std::vector<unsigned int>& indices)
 	setIndexData(indices.data(), indices.size());
 }
 
-void RenderMesh::setIndexData(unsigned int* data, size_t numElements)
+void RenderMesh::setIndexData(const unsigned int* data, size_t numElements)
 {
     setIndexData(data, numElements, GL_TRIANGLES);
 }
 
-void RenderMesh::setIndexData(unsigned int* data, size_t numElements, GLenum mode)
+void RenderMesh::setIndexData(const unsigned int* data, size_t numElements, GLenum mode)
 {
-	glBindVertexArray(mVAO);
+	glBindVertexArray(mBuffers->VAO);
+
+	if(!mBuffers->hasElementBuffer)
+	{
+		glGenBuffers(1, &mBuffers->EBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBuffers->EBO);
+		mBuffers->hasElementBuffer = true;
+	}
+
+    mBuffers->indexArraySize = numElements;
+	mBuffers->format = mode;
+	mBuffers->lods.clear();
+
+	// Upload the smallest index type that can hold the largest index
+	std::vector<uint32_t> chunkMax(Parallel::getNumThreads(0), 0);
+	Parallel::forRange(0, numElements, [&](size_t begin, size_t end, uint32_t chunkId)
+	{
+		chunkMax[chunkId] = internal::computeMaxIndex(data + begin, end - begin);
+	}, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+	const uint32_t maxIndex = *std::max_element(chunkMax.begin(), chunkMax.end());
 
-	if(!mHasElementBuffer)
+	if(maxIndex <= UINT8_MAX) mBuffers->indexType = GL_UNSIGNED_BYTE;
+	else if(maxIndex <= UINT16_MAX) mBuffers->indexType = GL_UNSIGNED_SHORT;
+	else mBuffers->indexType = GL_UNSIGNED_INT;
+
+	if(mBuffers->indexType == GL_UNSIGNED_INT || numElements == 0)
 	{
-		glGenBuffers(1, &mEBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
-		mHasElementBuffer = true;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, mBuffers->indexArraySize * getSize(mBuffers->indexType), data, GL_STATIC_DRAW);
+		glBindVertexArray(0);
+		return;
 	}
 
-    mIndexArraySize = numElements;
-	mFormat = mode;
+	// Narrow the indices while writing them into the mapped buffer
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mBuffers->indexArraySize * getSize(mBuffers->indexType), nullptr, GL_STATIC_DRAW);
+	void* buffer = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, mBuffers->indexArraySize * getSize(mBuffers->indexType), 
+									GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if(buffer == nullptr)
+	{
+		std::cout << "Error: index buffer could not be mapped" << std::endl;
+		glBindVertexArray(0);
+		return;
+	}
 
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexArraySize * sizeof(unsigned int), data, GL_STATIC_DRAW);
+	Parallel::forRange(0, numElements, [&](size_t begin, size_t end, uint32_t)
+	{
+		if(mBuffers->indexType == GL_UNSIGNED_SHORT) internal::narrowIndices(data + begin, end - begin, reinterpret_cast<uint16_t*>(buffer) + begin);
+		else internal::narrowIndices(data + begin, end - begin, reinterpret_cast<uint8_t*>(buffer) + begin);
+	}, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+	glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
 
 	glBindVertexArray(0);
 }
@@ -0,0 +1,156 @@
+#include "MyRender/StreamedMesh.h"
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <imgui.h>
+#include "MyRender/Camera.h"
+
+namespace myrender
+{
+
+StreamedMesh::~StreamedMesh()
+{
+	freePool();
+	if(mVAO != 0) glDeleteVertexArrays(1, &mVAO);
+}
+
+void StreamedMesh::start()
+{
+	if(mVAO != 0) return;
+	glGenVertexArrays(1, &mVAO);
+}
+
+bool StreamedMesh::open(const std::string& path)
+{
+	freePool();
+	if(!mMesh.open(path)) return false;
+	mInvalidPages.assign(mMesh.getNumPages(), false);
+	// Start with the whole mesh in range
+	mLoadDistance = glm::length(mMesh.getBoundingBox().getSize());
+	return true;
+}
+
+void StreamedMesh::setMemoryBudget(size_t bytes)
+{
+	mMemoryBudget = bytes;
+	freePool();
+}
+
+void StreamedMesh::freePool()
+{
+	if(mVBO != 0) glDeleteBuffers(1, &mVBO);
+	if(mEBO != 0) glDeleteBuffers(1, &mEBO);
+	mVBO = mEBO = 0;
+	mAllocated = false;
+}
+
+void StreamedMesh::allocatePool()
+{
+	const size_t vertexSlotBytes = mMesh.getMaxPageVertices() * sizeof(ChunkedMeshFile::PageVertex);
+	const size_t indexSlotBytes = mMesh.getMaxPageIndices() * sizeof(uint16_t);
+	const uint32_t numSlots = static_cast<uint32_t>(std::clamp<size_t>(mMemoryBudget / (vertexSlotBytes + indexSlotBytes),
+																	   1, mMesh.getNumPages()));
+	mCache.reset(numSlots, mMesh.getNumPages());
+
+	glBindVertexArray(mVAO);
+	glGenBuffers(1, &mVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+	glBufferData(GL_ARRAY_BUFFER, numSlots * vertexSlotBytes, nullptr, GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ChunkedMeshFile::PageVertex),
+						  reinterpret_cast<void*>(offsetof(ChunkedMeshFile::PageVertex, position)));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ChunkedMeshFile::PageVertex),
+						  reinterpret_cast<void*>(offsetof(ChunkedMeshFile::PageVertex, normal)));
+	glEnableVertexAttribArray(1);
+
+	glGenBuffers(1, &mEBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, numSlots * indexSlotBytes, nullptr, GL_DYNAMIC_DRAW);
+	glBindVertexArray(0);
+
+	mAllocated = true;
+}
+
+void StreamedMesh::uploadPage(uint32_t page, uint32_t slot)
+{
+	// Straight from the mapping, the pages read stay clean and the system can drop them at any time
+	const ChunkedMeshFile::Page& info = mMesh.getPage(page);
+	glBufferSubData(GL_ARRAY_BUFFER, slot * mMesh.getMaxPageVertices() * sizeof(ChunkedMeshFile::PageVertex),
+					info.numVertices * sizeof(ChunkedMeshFile::PageVertex), mMesh.getPageVertices(page));
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, slot * mMesh.getMaxPageIndices() * sizeof(uint16_t),
+					info.numIndices * sizeof(uint16_t), mMesh.getPageIndices(page));
+	mNumLoads++;
+}
+
+void StreamedMesh::draw(Camera* camera)
+{
+	if(!mMesh.isOpen() || mMesh.getNumPages() == 0) return;
+	if(!mAllocated) allocatePool();
+
+	const glm::vec3 cameraPosition = glm::vec3(glm::inverse(mTransform) * camera->getInverseViewMatrix()[3]);
+	mMesh.selectPages(cameraPosition, mLoadDistance, mVisiblePages);
+	mCache.nextFrame();
+
+	if(mShader == nullptr)
+	{
+		mShader = std::make_unique<Shader>();
+		mShader->load("BasicRender");
+	}
+	mShader->bind(camera, &mTransform);
+	mShader->setUniform("positionOffset", glm::vec3(0.0f));
+	mShader->setUniform("positionScale", glm::vec3(1.0f));
+	int octahedralNormals = 0;
+	mShader->setUniform("octahedralNormals", octahedralNormals);
+
+	glBindVertexArray(mVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+
+	mNumDrawnPages = 0;
+	mNumFrameLoads = 0;
+	for(uint32_t page : mVisiblePages)
+	{
+		uint32_t slot = mCache.find(page);
+		if(slot != PageCache::NONE)
+		{
+			mCache.touch(slot);
+		}
+		else
+		{
+			// Pages not loaded this frame are skipped, they come in nearest first in the next ones
+			uint32_t evictedPage;
+			if(mInvalidPages[page] || mNumFrameLoads == mMaxLoadsPerFrame) continue;
+			if(!mMesh.hasValidIndices(page))
+			{
+				std::cout << "Error: the page " << page << " has indices out of its vertices, it is not drawn" << std::endl;
+				mInvalidPages[page] = true;
+				continue;
+			}
+			slot = mCache.acquire(page, evictedPage);
+			if(slot == PageCache::NONE) continue;
+			uploadPage(page, slot);
+			mNumFrameLoads++;
+		}
+
+		const void* indexOffset = reinterpret_cast<void*>(slot * mMesh.getMaxPageIndices() * sizeof(uint16_t));
+		glDrawElementsBaseVertex(GL_TRIANGLES, mMesh.getPage(page).numIndices, GL_UNSIGNED_SHORT, indexOffset,
+								 static_cast<GLint>(slot * mMesh.getMaxPageVertices()));
+		mNumDrawnPages++;
+	}
+
+	glBindVertexArray(0);
+}
+
+void StreamedMesh::drawGui()
+{
+	ImGui::Spacing();
+	ImGui::Separator();
+	ImGui::Text((systemName == "") ? "StreamedMesh" : systemName.c_str());
+	if(!mMesh.isOpen()) return;
+	ImGui::Text("%u / %u pages drawn, %u in range", mNumDrawnPages, mMesh.getNumPages(), static_cast<uint32_t>(mVisiblePages.size()));
+	ImGui::Text("%u / %u slots resident, %.1f MB budget", mCache.getNumResidentPages(), mCache.getNumSlots(),
+				static_cast<float>(mMemoryBudget) / static_cast<float>(1 << 20));
+	ImGui::Text("%u loads this frame, %zu in total", mNumFrameLoads, mNumLoads);
+	ImGui::SliderFloat("Load distance", &mLoadDistance, 0.0f, glm::length(mMesh.getBoundingBox().getSize()));
+}
+
+}
@@ -0,0 +1,323 @@
+#include "MyRender/utils/ChunkedMesh.h"
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+#include "utils/MeshNormals.h"
+#include "utils/MortonOrder.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace myrender
+{
+
+namespace internal
+{
+    constexpr uint32_t CHUNKED_NO_VERTEX = ~0u;
+
+    uint64_t alignPageOffset(uint64_t offset)
+    {
+        return (offset + ChunkedMeshFile::PAGE_ALIGNMENT - 1) / ChunkedMeshFile::PAGE_ALIGNMENT * ChunkedMeshFile::PAGE_ALIGNMENT;
+    }
+
+    // Page being assembled. localIds maps the mesh vertices to the page ones and is reset after each page
+    struct PageBuilder
+    {
+        std::vector<uint32_t> localIds;
+        std::vector<uint32_t> globalIds;
+        std::vector<uint16_t> indices;
+
+        uint32_t countNewVertices(const uint32_t* triangle) const
+        {
+            uint32_t count = 0;
+            for(uint32_t k = 0; k < 3; k++)
+            {
+                const bool repeated = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+                count += !repeated && localIds[triangle[k]] == CHUNKED_NO_VERTEX;
+            }
+            return count;
+        }
+
+        void addTriangle(const uint32_t* triangle)
+        {
+            for(uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t& local = localIds[triangle[k]];
+                if(local == CHUNKED_NO_VERTEX)
+                {
+                    local = static_cast<uint32_t>(globalIds.size());
+                    globalIds.push_back(triangle[k]);
+                }
+                indices.push_back(static_cast<uint16_t>(local));
+            }
+        }
+
+        void clear()
+        {
+            for(uint32_t v : globalIds) localIds[v] = CHUNKED_NO_VERTEX;
+            globalIds.clear();
+            indices.clear();
+        }
+    };
+}
+
+bool ChunkedMeshFile::write(const std::string& path, const glm::vec3* vertices, const glm::vec3* normals, size_t numVertices,
+                            const uint32_t* indices, size_t numIndices, uint32_t pageTriangles, uint32_t numThreads)
+{
+    using namespace internal;
+    const size_t numTriangles = numIndices / 3;
+    pageTriangles = std::max(pageTriangles, 1u);
+
+    std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(numThreads));
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t chunkId)
+    {
+        chunkBoxes[chunkId] = internal::computeBoundingBox(vertices + begin, end - begin);
+    }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+    BoundingBox bounds;
+    for(const BoundingBox& box : chunkBoxes) bounds.addBoundingBox(box);
+
+    // Triangles along the Z-order curve of their centroids, so consecutive ones are close in space
+    std::atomic<bool> validIndices(true);
+    std::vector<uint32_t> keys(numTriangles), order(numTriangles);
+    const MortonEncoder encoder(bounds);
+    Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+    {
+        bool valid = true;
+        for(size_t t = begin; t < end; t++)
+        {
+            const uint32_t* triangle = indices + 3 * t;
+            order[t] = static_cast<uint32_t>(t);
+            keys[t] = 0;
+            if(triangle[0] >= numVertices || triangle[1] >= numVertices || triangle[2] >= numVertices)
+            {
+                valid = false;
+                continue;
+            }
+            keys[t] = encoder.encode((vertices[triangle[0]] + vertices[triangle[1]] + vertices[triangle[2]]) / 3.0f);
+        }
+        if(!valid) validIndices = false;
+    }, numThreads);
+    if(!validIndices)
+    {
+        std::cout << "Error: the mesh has indices out of its vertices" << std::endl;
+        return false;
+    }
+    radixSort(keys, order, numThreads);
+    std::vector<uint32_t>().swap(keys);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        std::cout << "Error: the file " << path << " could not be opened for writing" << std::endl;
+        return false;
+    }
+
+    Header header = {MAGIC, VERSION, 0, 0, 0, 0, bounds, 0, 0};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    uint64_t position = sizeof(Header);
+
+    std::vector<Page> pages;
+    PageBuilder builder;
+    builder.localIds.assign(numVertices, CHUNKED_NO_VERTEX);
+    std::vector<PageVertex> pageVertices;
+    std::vector<glm::vec3> localPositions, localNormals;
+    std::vector<uint32_t> localIndices;
+    const char padding[PAGE_ALIGNMENT] = {};
+    auto writePage = [&]()
+    {
+        if(builder.indices.empty()) return;
+        const size_t numPageVertices = builder.globalIds.size();
+        pageVertices.resize(numPageVertices);
+        Page page = {BoundingBox(), static_cast<uint32_t>(numPageVertices), static_cast<uint32_t>(builder.indices.size()), 0};
+        for(size_t v = 0; v < numPageVertices; v++)
+        {
+            pageVertices[v].position = vertices[builder.globalIds[v]];
+            if(normals != nullptr) pageVertices[v].normal = normals[builder.globalIds[v]];
+            page.bounds.addPoint(pageVertices[v].position);
+        }
+
+        if(normals == nullptr)
+        {
+            localPositions.resize(numPageVertices);
+            for(size_t v = 0; v < numPageVertices; v++) localPositions[v] = pageVertices[v].position;
+            localIndices.assign(builder.indices.begin(), builder.indices.end());
+            internal::computeNormals(localPositions, localIndices, localNormals, 1);
+            for(size_t v = 0; v < numPageVertices; v++) pageVertices[v].normal = localNormals[v];
+        }
+
+        page.offset = alignPageOffset(position);
+        file.write(padding, page.offset - position);
+        file.write(reinterpret_cast<const char*>(pageVertices.data()), numPageVertices * sizeof(PageVertex));
+        file.write(reinterpret_cast<const char*>(builder.indices.data()), builder.indices.size() * sizeof(uint16_t));
+        position = page.offset + numPageVertices * sizeof(PageVertex) + builder.indices.size() * sizeof(uint16_t);
+
+        header.maxPageVertices = std::max(header.maxPageVertices, page.numVertices);
+        header.maxPageIndices = std::max(header.maxPageIndices, page.numIndices);
+        pages.push_back(page);
+        builder.clear();
+    };
+
+    uint32_t numPageTriangles = 0;
+    for(size_t t = 0; t < numTriangles; t++)
+    {
+        const uint32_t* triangle = indices + 3 * order[t];
+        if(numPageTriangles == pageTriangles || builder.globalIds.size() + builder.countNewVertices(triangle) > MAX_PAGE_VERTICES)
+        {
+            writePage();
+            numPageTriangles = 0;
+        }
+        builder.addTriangle(triangle);
+        numPageTriangles++;
+    }
+    writePage();
+
+    header.numPages = static_cast<uint32_t>(pages.size());
+    header.pageTableOffset = alignPageOffset(position);
+    header.fileSize = header.pageTableOffset + pages.size() * sizeof(Page);
+    file.write(padding, header.pageTableOffset - position);
+    file.write(reinterpret_cast<const char*>(pages.data()), pages.size() * sizeof(Page));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    if(!file.good())
+    {
+        std::cout << "Error: the file " << path << " could not be written" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MappedChunkedMesh::open(const std::string& path)
+{
+    close();
+    // The pages are read in the order the camera needs them
+    if(!mFile.open(path, false))
+    {
+        std::cout << "Error: the file " << path << " could not be mapped" << std::endl;
+        return false;
+    }
+
+    auto fail = [&](const char* reason)
+    {
+        std::cout << "Error: " << path << " is not a valid chunked mesh file, " << reason << std::endl;
+        close();
+        return false;
+    };
+
+    const uint8_t* fileData = mFile.getData();
+    const size_t fileSize = mFile.getSize();
+    if(fileSize < sizeof(ChunkedMeshFile::Header)) return fail("it is too small");
+    std::memcpy(&mHeader, fileData, sizeof(ChunkedMeshFile::Header));
+    if(mHeader.magic != ChunkedMeshFile::MAGIC) return fail("wrong magic number");
+    if(mHeader.version > ChunkedMeshFile::VERSION) return fail("unsupported version");
+    if(mHeader.fileSize > fileSize) return fail("it is truncated");
+    if(mHeader.maxPageVertices > ChunkedMeshFile::MAX_PAGE_VERTICES) return fail("pages larger than the maximum");
+    // Written with divisions and subtractions, so crafted sizes cannot wrap around
+    if(mHeader.pageTableOffset > fileSize || mHeader.numPages > (fileSize - mHeader.pageTableOffset) / sizeof(ChunkedMeshFile::Page))
+    {
+        return fail("the page table is truncated");
+    }
+
+    mPages.resize(mHeader.numPages);
+    std::memcpy(mPages.data(), fileData + mHeader.pageTableOffset, mPages.size() * sizeof(ChunkedMeshFile::Page));
+    for(const ChunkedMeshFile::Page& page : mPages)
+    {
+        if(page.offset % ChunkedMeshFile::PAGE_ALIGNMENT != 0) return fail("misaligned page");
+        if(page.numVertices > mHeader.maxPageVertices || page.numIndices > mHeader.maxPageIndices) return fail("page larger than the maximum");
+        const uint64_t pageSize = static_cast<uint64_t>(page.numVertices) * sizeof(ChunkedMeshFile::PageVertex) +
+                                  static_cast<uint64_t>(page.numIndices) * sizeof(uint16_t);
+        if(page.offset > fileSize || pageSize > fileSize - page.offset) return fail("page out of the file");
+    }
+    return true;
+}
+
+bool MappedChunkedMesh::hasValidIndices(uint32_t page) const
+{
+    const uint32_t numVertices = mPages[page].numVertices;
+    const uint16_t* indices = getPageIndices(page);
+    for(uint32_t i = 0; i < mPages[page].numIndices; i++)
+    {
+        if(indices[i] >= numVertices) return false;
+    }
+    return true;
+}
+
+void MappedChunkedMesh::close()
+{
+    mFile.close();
+    mHeader = {};
+    mPages.clear();
+}
+
+void MappedChunkedMesh::selectPages(const glm::vec3& point, float maxDistance, std::vector<uint32_t>& pages) const
+{
+    std::vector<std::pair<float, uint32_t>> candidates;
+    const float maxDistance2 = maxDistance * maxDistance;
+    for(uint32_t p = 0; p < mPages.size(); p++)
+    {
+        const BoundingBox& box = mPages[p].bounds;
+        const glm::vec3 offset = glm::max(glm::max(box.min - point, point - box.max), glm::vec3(0.0f));
+        const float distance2 = glm::dot(offset, offset);
+        if(distance2 <= maxDistance2) candidates.emplace_back(distance2, p);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    pages.clear();
+    for(const std::pair<float, uint32_t>& candidate : candidates) pages.push_back(candidate.second);
+}
+
+void PageCache::reset(uint32_t numSlots, uint32_t numPages)
+{
+    mSlots.assign(numSlots, Slot());
+    mPageSlots.assign(numPages, NONE);
+    mNumResident = 0;
+    mFirst = mLast = NONE;
+    // Empty slots start as the least recently used ones
+    for(uint32_t s = 0; s < numSlots; s++) pushFront(s);
+}
+
+void PageCache::touch(uint32_t slot)
+{
+    mSlots[slot].lastFrame = mFrame;
+    if(mFirst == slot) return;
+    unlink(slot);
+    pushFront(slot);
+}
+
+uint32_t PageCache::acquire(uint32_t page, uint32_t& evictedPage)
+{
+    evictedPage = NONE;
+    const uint32_t slot = mLast;
+    if(slot == NONE || mSlots[slot].lastFrame == mFrame) return NONE;
+
+    evictedPage = mSlots[slot].page;
+    if(evictedPage != NONE) mPageSlots[evictedPage] = NONE;
+    else mNumResident++;
+    mSlots[slot].page = page;
+    mPageSlots[page] = slot;
+    touch(slot);
+    return slot;
+}
+
+void PageCache::unlink(uint32_t slot)
+{
+    Slot& s = mSlots[slot];
+    if(s.previous != NONE) mSlots[s.previous].next = s.next;
+    else mFirst = s.next;
+    if(s.next != NONE) mSlots[s.next].previous = s.previous;
+    else mLast = s.previous;
+    s.previous = s.next = NONE;
+}
+
+void PageCache::pushFront(uint32_t slot)
+{
+    Slot& s = mSlots[slot];
+    s.previous = NONE;
+    s.next = mFirst;
+    if(mFirst != NONE) mSlots[mFirst].previous = slot;
+    mFirst = slot;
+    if(mLast == NONE) mLast = slot;
+}
+
+}
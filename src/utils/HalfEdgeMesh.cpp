@@ -0,0 +1,94 @@
+#include "MyRender/utils/HalfEdgeMesh.h"
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+
+namespace myrender
+{
+
+void HalfEdgeMesh::build(const Mesh& mesh, uint32_t numThreads)
+{
+    mMesh = &mesh;
+    const std::vector<uint32_t>& indices = mesh.getIndices();
+    const size_t numVertices = mesh.getVertices().size();
+    const size_t numHalfEdges = indices.size() - indices.size() % 3;
+
+    // The twin of a -> b is among the corners of b, a few per vertex, so no hash map or sort is needed
+    const VertexAdjacency adjacency = internal::computeVertexAdjacency(indices, numVertices, numThreads);
+
+    const uint32_t numChunks = Parallel::getNumThreads(numThreads);
+    std::vector<uint32_t> chunkBoundary(numChunks, 0), chunkNonManifold(numChunks, 0);
+    mTwins.resize(numHalfEdges);
+    Parallel::forRange(0, numHalfEdges, [&](size_t begin, size_t end, uint32_t chunkId)
+    {
+        uint32_t numBoundary = 0, numNonManifold = 0;
+        for(size_t h = begin; h < end; h++)
+        {
+            const uint32_t from = indices[h], to = indices[getNext(static_cast<uint32_t>(h))];
+            uint32_t numSame = 0, numOpposite = 0, twin = INVALID;
+            for(uint32_t c = adjacency.offsets[from]; c < adjacency.offsets[from + 1]; c++)
+            {
+                numSame += indices[getNext(adjacency.corners[c])] == to;
+            }
+            for(uint32_t c = adjacency.offsets[to]; c < adjacency.offsets[to + 1]; c++)
+            {
+                const uint32_t corner = adjacency.corners[c];
+                if(indices[getNext(corner)] != from) continue;
+                numOpposite++;
+                twin = corner;
+            }
+
+            if(from != to && numSame == 1 && numOpposite <= 1)
+            {
+                mTwins[h] = twin;
+                numBoundary += numOpposite == 0;
+            }
+            else
+            {
+                mTwins[h] = NON_MANIFOLD;
+                numNonManifold++;
+            }
+        }
+        chunkBoundary[chunkId] = numBoundary;
+        chunkNonManifold[chunkId] = numNonManifold;
+    }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+
+    mNumBoundaryHalfEdges = 0;
+    mNumNonManifoldHalfEdges = 0;
+    for(uint32_t chunk = 0; chunk < numChunks; chunk++)
+    {
+        mNumBoundaryHalfEdges += chunkBoundary[chunk];
+        mNumNonManifoldHalfEdges += chunkNonManifold[chunk];
+    }
+
+    // Start each vertex on a half edge without twin, so the counter clockwise walk covers its whole fan, and
+    // check that the walk reaches all its corners
+    std::vector<std::vector<uint32_t>> chunkVertices(numChunks);
+    mVertexHalfEdges.resize(numVertices);
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t chunkId)
+    {
+        for(size_t v = begin; v < end; v++)
+        {
+            const uint32_t first = adjacency.offsets[v], last = adjacency.offsets[v + 1];
+            uint32_t start = first < last ? adjacency.corners[first] : INVALID;
+            for(uint32_t c = first; c < last; c++)
+            {
+                if(hasTwin(adjacency.corners[c])) continue;
+                start = adjacency.corners[c];
+                break;
+            }
+            mVertexHalfEdges[v] = start;
+
+            uint32_t numVisited = 0;
+            forEachOutgoing(static_cast<uint32_t>(v), [&](uint32_t) { numVisited++; });
+            if(numVisited != last - first) chunkVertices[chunkId].push_back(static_cast<uint32_t>(v));
+        }
+    }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+
+    mNonManifoldVertices.clear();
+    for(const std::vector<uint32_t>& vertices : chunkVertices)
+    {
+        mNonManifoldVertices.insert(mNonManifoldVertices.end(), vertices.begin(), vertices.end());
+    }
+}
+
+}
@@ -0,0 +1,242 @@
+#include "MyRender/utils/IsosurfaceExtractor.h"
+#include "MyRender/utils/Parallel.h"
+#include <algorithm>
+#include <cstring>
+
+namespace myrender
+{
+
+namespace internal
+{
+    constexpr uint32_t ISO_NO_VERTEX = ~0u;
+    // Corner c of a cell is at offset (c & 1, (c >> 1) & 1, c >> 2)
+    constexpr uint8_t ISO_CELL_EDGES[12][2] = {{0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3},
+                                               {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+    struct Volume
+    {
+        const float* values;
+        glm::uvec3 resolution;
+        float isoValue;
+
+        float get(uint32_t x, uint32_t y, uint32_t z) const
+        {
+            return values[(static_cast<size_t>(z) * resolution.y + y) * resolution.x + x];
+        }
+
+        // Central differences, one sided on the borders. Only the direction is used
+        glm::vec3 getGradient(uint32_t x, uint32_t y, uint32_t z) const
+        {
+            const glm::uvec3 maxSample = resolution - glm::uvec3(1);
+            const uint32_t x0 = x > 0 ? x - 1 : x, x1 = std::min(x + 1, maxSample.x);
+            const uint32_t y0 = y > 0 ? y - 1 : y, y1 = std::min(y + 1, maxSample.y);
+            const uint32_t z0 = z > 0 ? z - 1 : z, z1 = std::min(z + 1, maxSample.z);
+            return glm::vec3((get(x1, y, z) - get(x0, y, z)) / static_cast<float>(x1 - x0),
+                             (get(x, y1, z) - get(x, y0, z)) / static_cast<float>(y1 - y0),
+                             (get(x, y, z1) - get(x, y, z0)) / static_cast<float>(z1 - z0));
+        }
+
+        // Bit c of masks[x] is set when the corner c of the cell (x, y, z) is inside. Each sample is read once
+        void getRowMasks(uint32_t y, uint32_t z, uint8_t* masks) const
+        {
+            const size_t rowSize = resolution.x, layerSize = static_cast<size_t>(resolution.y) * resolution.x;
+            const float* row00 = values + z * layerSize + y * rowSize;
+            const float* row10 = row00 + rowSize;
+            const float* row01 = row00 + layerSize;
+            const float* row11 = row01 + rowSize;
+            auto getColumn = [&](uint32_t x)
+            {
+                return static_cast<uint32_t>(row00[x] < isoValue) | static_cast<uint32_t>(row10[x] < isoValue) << 2 |
+                       static_cast<uint32_t>(row01[x] < isoValue) << 4 | static_cast<uint32_t>(row11[x] < isoValue) << 6;
+            };
+
+            uint32_t previous = getColumn(0);
+            for(uint32_t x = 0; x + 1 < resolution.x; x++)
+            {
+                const uint32_t next = getColumn(x + 1);
+                masks[x] = static_cast<uint8_t>(previous | next << 1);
+                previous = next;
+            }
+        }
+    };
+
+    inline bool isCellCrossed(uint32_t mask) { return mask != 0 && mask != 0xff; }
+
+    // Vertex of a crossed cell at the mean of the crossings of its edges, in samples from the cell origin
+    void computeCellVertex(const Volume& volume, uint32_t x, uint32_t y, uint32_t z, uint32_t mask, glm::vec3& position, glm::vec3& normal)
+    {
+        float values[8];
+        for(uint32_t c = 0; c < 8; c++) values[c] = volume.get(x + (c & 1), y + ((c >> 1) & 1), z + (c >> 2));
+        // Gradients only at the ends of the crossed edges
+        glm::vec3 gradients[8];
+        uint32_t hasGradient = 0;
+        auto getGradient = [&](uint32_t c)
+        {
+            if(((hasGradient >> c) & 1) == 0)
+            {
+                gradients[c] = volume.getGradient(x + (c & 1), y + ((c >> 1) & 1), z + (c >> 2));
+                hasGradient |= 1u << c;
+            }
+            return gradients[c];
+        };
+
+        glm::vec3 positionSum(0.0f), gradientSum(0.0f);
+        uint32_t numCrossings = 0;
+        for(const uint8_t* edge : ISO_CELL_EDGES)
+        {
+            const uint32_t c0 = edge[0], c1 = edge[1];
+            if(((mask >> c0) & 1) == ((mask >> c1) & 1)) continue;
+            const float t = (volume.isoValue - values[c0]) / (values[c1] - values[c0]);
+            const glm::vec3 p0(c0 & 1, (c0 >> 1) & 1, c0 >> 2);
+            const glm::vec3 p1(c1 & 1, (c1 >> 1) & 1, c1 >> 2);
+            positionSum += p0 + t * (p1 - p0);
+            const glm::vec3 g0 = getGradient(c0);
+            gradientSum += g0 + t * (getGradient(c1) - g0);
+            numCrossings++;
+        }
+
+        position = positionSum / static_cast<float>(numCrossings);
+        const float length = glm::length(gradientSum);
+        normal = length > 0.0f ? gradientSum / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+
+    // Numbers the crossed cells of layer z from firstVertex in x then y order, so every slab gets the same ids
+    // for a layer, and keeps their masks. The vertices are written only when vertices is not null
+    void numberLayer(const Volume& volume, uint32_t z, uint32_t firstVertex, std::vector<uint32_t>& ids, std::vector<uint8_t>& masks,
+                     const glm::vec3& origin, float voxelSize, glm::vec3* vertices, glm::vec3* normals)
+    {
+        const uint32_t numCellsX = volume.resolution.x - 1, numCellsY = volume.resolution.y - 1;
+        ids.resize(static_cast<size_t>(numCellsX) * numCellsY);
+        masks.resize(ids.size());
+        uint32_t vertex = firstVertex;
+        for(uint32_t y = 0; y < numCellsY; y++)
+        {
+            volume.getRowMasks(y, z, masks.data() + y * numCellsX);
+            for(uint32_t x = 0; x < numCellsX; x++)
+            {
+                const uint32_t mask = masks[y * numCellsX + x];
+                if(!isCellCrossed(mask))
+                {
+                    ids[y * numCellsX + x] = ISO_NO_VERTEX;
+                    continue;
+                }
+
+                ids[y * numCellsX + x] = vertex;
+                if(vertices != nullptr)
+                {
+                    glm::vec3 position;
+                    computeCellVertex(volume, x, y, z, mask, position, normals[vertex]);
+                    vertices[vertex] = origin + voxelSize * (glm::vec3(x, y, z) + position);
+                }
+                vertex++;
+            }
+        }
+    }
+
+    // Two triangles between the vertices of the four cells around a crossed edge. They are given counter clockwise
+    // seen from the end of the edge, which is the outside when its start is inside
+    inline void addQuad(std::vector<uint32_t>& indices, bool startInside, uint32_t v0, uint32_t v1, uint32_t v2, uint32_t v3)
+    {
+        if(!startInside) std::swap(v1, v3);
+        indices.insert(indices.end(), {v0, v1, v2, v0, v2, v3});
+    }
+}
+
+std::shared_ptr<Mesh> IsosurfaceExtractor::extract(const float* values, const glm::uvec3& resolution, const glm::vec3& origin,
+                                                   float voxelSize, float isoValue, uint32_t numThreads)
+{
+    using namespace internal;
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    if(values == nullptr || resolution.x < 2 || resolution.y < 2 || resolution.z < 2) return mesh;
+
+    const Volume volume = {values, resolution, isoValue};
+    const uint32_t numLayers = resolution.z - 1;
+    const uint32_t numCellsX = resolution.x - 1, numCellsY = resolution.y - 1;
+
+    // Crossed cells per layer, which give the first vertex of each layer
+    std::vector<uint32_t> layerVertices(numLayers + 1, 0);
+    Parallel::forRange(0, numLayers, [&](size_t begin, size_t end, uint32_t)
+    {
+        std::vector<uint8_t> rowMasks(numCellsX);
+        for(uint32_t z = static_cast<uint32_t>(begin); z < end; z++)
+        {
+            uint32_t count = 0;
+            for(uint32_t y = 0; y < numCellsY; y++)
+            {
+                volume.getRowMasks(y, z, rowMasks.data());
+                for(uint32_t x = 0; x < numCellsX; x++) count += isCellCrossed(rowMasks[x]);
+            }
+            layerVertices[z + 1] = count;
+        }
+    }, numThreads, 1);
+    for(uint32_t z = 0; z < numLayers; z++) layerVertices[z + 1] += layerVertices[z];
+
+    std::vector<glm::vec3>& vertices = mesh->getVertices();
+    std::vector<glm::vec3>& normals = mesh->getNormals();
+    vertices.resize(layerVertices[numLayers]);
+    normals.resize(layerVertices[numLayers]);
+
+    // Each slab writes the vertices of its layers and the quads of the edges in them. The x and y edges on the
+    // bottom face of a layer need the ids of the layer below, which the slab numbers again without writing
+    std::vector<std::vector<uint32_t>> slabIndices(Parallel::getNumThreads(numThreads));
+    Parallel::forRange(0, numLayers, [&](size_t begin, size_t end, uint32_t chunkId)
+    {
+        std::vector<uint32_t>& indices = slabIndices[chunkId];
+        std::vector<uint32_t> below, current;
+        std::vector<uint8_t> masks;
+        if(begin > 0)
+        {
+            numberLayer(volume, static_cast<uint32_t>(begin - 1), layerVertices[begin - 1], below, masks, origin, voxelSize, nullptr, nullptr);
+        }
+
+        for(uint32_t z = static_cast<uint32_t>(begin); z < end; z++)
+        {
+            numberLayer(volume, z, layerVertices[z], current, masks, origin, voxelSize, vertices.data(), normals.data());
+            auto cell = [&](const std::vector<uint32_t>& ids, uint32_t x, uint32_t y) { return ids[y * numCellsX + x]; };
+
+            // The edges starting at corner 0 of each cell, the mask gives the sides of their ends
+            for(uint32_t y = 0; y < numCellsY; y++)
+            {
+                for(uint32_t x = 0; x < numCellsX; x++)
+                {
+                    const uint32_t mask = masks[y * numCellsX + x];
+                    if(mask == 0 || mask == 0xff) continue;
+                    const bool inside = (mask & 1) != 0;
+                    // Edge along z, inside the layer
+                    if(x > 0 && y > 0 && inside != ((mask >> 4) & 1))
+                    {
+                        addQuad(indices, inside, cell(current, x - 1, y - 1), cell(current, x, y - 1), cell(current, x, y), cell(current, x - 1, y));
+                    }
+                    if(z == 0) continue;
+                    // Edges along x and y on the bottom face of the layer
+                    if(y > 0 && inside != ((mask >> 1) & 1))
+                    {
+                        addQuad(indices, inside, cell(below, x, y - 1), cell(below, x, y), cell(current, x, y), cell(current, x, y - 1));
+                    }
+                    if(x > 0 && inside != ((mask >> 2) & 1))
+                    {
+                        addQuad(indices, inside, cell(below, x - 1, y), cell(current, x - 1, y), cell(current, x, y), cell(below, x, y));
+                    }
+                }
+            }
+            std::swap(below, current);
+        }
+    }, numThreads, 1);
+
+    std::vector<size_t> slabOffsets(slabIndices.size() + 1, 0);
+    for(size_t s = 0; s < slabIndices.size(); s++) slabOffsets[s + 1] = slabOffsets[s] + slabIndices[s].size();
+    std::vector<uint32_t>& indices = mesh->getIndices();
+    indices.resize(slabOffsets.back());
+    Parallel::forRange(0, slabIndices.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t s = begin; s < end; s++)
+        {
+            if(!slabIndices[s].empty()) std::memcpy(indices.data() + slabOffsets[s], slabIndices[s].data(), slabIndices[s].size() * sizeof(uint32_t));
+        }
+    }, numThreads, 1);
+
+    mesh->computeBoundingBox(numThreads);
+    return mesh;
+}
+
+}
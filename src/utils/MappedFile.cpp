@@ -0,0 +1,91 @@
+#include "MyRender/utils/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace myrender
+{
+
+bool MappedFile::open(const std::string& path, bool sequential)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | (sequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0), nullptr);
+    if(file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mFileHandle = file;
+    mMappingHandle = mapping;
+    mData = reinterpret_cast<const uint8_t*>(data);
+    mSize = static_cast<size_t>(size.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if(file < 0) return false;
+
+    struct stat info;
+    if(fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file); // The mapping keeps its own reference to the file
+    if(data == MAP_FAILED) return false;
+
+    // Start reading ahead, the whole file is going to be used
+    if(sequential) madvise(data, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+
+    mData = reinterpret_cast<const uint8_t*>(data);
+    mSize = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(mData == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mData);
+    CloseHandle(reinterpret_cast<HANDLE>(mMappingHandle));
+    CloseHandle(reinterpret_cast<HANDLE>(mFileHandle));
+    mMappingHandle = nullptr;
+    mFileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+    mData = nullptr;
+    mSize = 0;
+}
+
+}
@@ -1,6 +1,12 @@
 #include <iostream>
 #include <assert.h>
+#include <atomic>
+#include <memory>
+#include <algorithm>
 #include <MyRender/utils/Mesh.h>
+#include <MyRender/utils/Parallel.h>
+#include "utils/MeshKernels.h"
+#include "utils/MeshNormals.h"
 
 namespace myrender
 {
@@ -8,62 +14,125 @@ namespace myrender
 Mesh::Mesh(glm::vec3* vertices, uint32_t numVertices,
            uint32_t* indices, uint32_t numIndices)
 {
-    mVertices.resize(numVertices);
-    std::memcpy(mVertices.data(), vertices, sizeof(glm::vec3) * numVertices);
+    mVertices.rewrite().assign(vertices, vertices + numVertices);
+    mIndices.rewrite().assign(indices, indices + numIndices);
+}
+
+void Mesh::releaseData()
+{
+    mVertices.release();
+    mIndices.release();
+    mNormals.release();
+    mTexCoords.release();
+    mTangents.release();
+}
 
-    mIndices.resize(numIndices);
-    std::memcpy(mIndices.data(), indices, sizeof(uint32_t) * numIndices);
+bool Mesh::isShared() const
+{
+    return mVertices.isShared() || mIndices.isShared() || mNormals.isShared() || mTexCoords.isShared() || mTangents.isShared();
 }
 
-void Mesh::computeBoundingBox()
+void Mesh::computeBoundingBox(uint32_t numThreads)
 {
-    glm::vec3 min(INFINITY);
-    glm::vec3 max(-INFINITY);
-    for(glm::vec3& vert : mVertices)
+    const std::vector<glm::vec3>& vertices = mVertices.get();
+    std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(numThreads));
+    Parallel::forRange(0, vertices.size(), [&](size_t begin, size_t end, uint32_t chunkId)
     {
-        min.x = glm::min(min.x, vert.x);
-        max.x = glm::max(max.x, vert.x);
+        chunkBoxes[chunkId] = internal::computeBoundingBox(vertices.data() + begin, end - begin);
+    }, numThreads, PARALLEL_KERNELS_MIN_VERTICES);
+
+    mBBox = BoundingBox();
+    for(const BoundingBox& box : chunkBoxes) mBBox.addBoundingBox(box);
+}
 
-        min.y = glm::min(min.y, vert.y);
-        max.y = glm::max(max.y, vert.y);
+void Mesh::computeNormals(uint32_t numThreads)
+{
+    internal::computeNormals(mVertices.get(), mIndices.get(), mNormals.rewrite(), numThreads);
+}
 
-        min.z = glm::min(min.z, vert.z);
-        max.z = glm::max(max.z, vert.z);
-    }
-    mBBox = BoundingBox(min, max);
+VertexAdjacency Mesh::computeVertexAdjacency(uint32_t numThreads) const
+{
+    return internal::computeVertexAdjacency(mIndices.get(), mVertices.size(), numThreads);
 }
 
-void Mesh::computeNormals()
+VertexAdjacency internal::computeVertexAdjacency(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t numThreads)
 {
-    mNormals.clear();
-    mNormals.assign(mVertices.size(), glm::vec3(0.0f));
+    const size_t numCorners = indices.size() - indices.size() % 3;
+
+    VertexAdjacency adjacency;
+    adjacency.offsets.resize(numVertices + 1);
+    adjacency.offsets[0] = 0;
 
-    for (int i = 0; i < mIndices.size(); i += 3)
+    if(Parallel::getNumThreads(numThreads) == 1)
     {
-        const glm::vec3 v1 = mVertices[mIndices[i]];
-        const glm::vec3 v2 = mVertices[mIndices[i + 1]];
-        const glm::vec3 v3 = mVertices[mIndices[i + 2]];
-        const glm::vec3 normal = glm::normalize(glm::cross(v2 - v1, v3 - v1));
-
-        mNormals[mIndices[i]] += glm::acos(glm::dot(glm::normalize(v2 - v1), glm::normalize(v3 - v1))) * normal;
-        mNormals[mIndices[i + 1]] += glm::acos(glm::dot(glm::normalize(v1 - v2), glm::normalize(v3 - v2))) * normal;
-        mNormals[mIndices[i + 2]] += glm::acos(glm::dot(glm::normalize(v1 - v3), glm::normalize(v2 - v3))) * normal;
+        // A serial scatter inserts the corners already sorted, without atomics
+        std::vector<uint32_t> cursors(numVertices, 0);
+        for(size_t c = 0; c < numCorners; c++) cursors[indices[c]]++;
+        for(size_t v = 0; v < numVertices; v++)
+        {
+            adjacency.offsets[v + 1] = adjacency.offsets[v] + cursors[v];
+            cursors[v] = adjacency.offsets[v];
+        }
+
+        adjacency.corners.resize(numCorners);
+        for(size_t c = 0; c < numCorners; c++) adjacency.corners[cursors[indices[c]]++] = static_cast<uint32_t>(c);
+        return adjacency;
     }
 
-    for(glm::vec3& n : mNormals)
+    // Count the corners of each vertex
+    std::unique_ptr<std::atomic<uint32_t>[]> counters(new std::atomic<uint32_t>[numVertices]);
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t v = begin; v < end; v++) counters[v].store(0, std::memory_order_relaxed);
+    }, numThreads);
+
+    Parallel::forRange(0, numCorners, [&](size_t begin, size_t end, uint32_t)
     {
-        n = glm::normalize(n);
+        for(size_t c = begin; c < end; c++) counters[indices[c]].fetch_add(1, std::memory_order_relaxed);
+    }, numThreads);
+
+    for(size_t v = 0; v < numVertices; v++)
+    {
+        adjacency.offsets[v + 1] = adjacency.offsets[v] + counters[v].load(std::memory_order_relaxed);
+        counters[v].store(adjacency.offsets[v], std::memory_order_relaxed);
     }
+
+    // Scatter the corners using the counters as insertion cursors
+    adjacency.corners.resize(numCorners);
+    Parallel::forRange(0, numCorners, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t c = begin; c < end; c++)
+        {
+            const uint32_t pos = counters[indices[c]].fetch_add(1, std::memory_order_relaxed);
+            adjacency.corners[pos] = static_cast<uint32_t>(c);
+        }
+    }, numThreads);
+
+    // The insertion order depends on the thread scheduling, sort to make the result deterministic
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t v = begin; v < end; v++)
+        {
+            std::sort(adjacency.corners.begin() + adjacency.offsets[v],
+                      adjacency.corners.begin() + adjacency.offsets[v + 1]);
+        }
+    }, numThreads);
+
+    return adjacency;
 }
 
-void Mesh::applyTransform(glm::mat4 trans)
+void Mesh::applyTransform(glm::mat4 trans, uint32_t numThreads)
 {
-    for(glm::vec3& vert : mVertices)
+    // The bounding box is computed in the same pass as the transformation. Only the vertices stop being shared
+    std::vector<glm::vec3>& vertices = mVertices.edit();
+    std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(numThreads));
+    Parallel::forRange(0, vertices.size(), [&](size_t begin, size_t end, uint32_t chunkId)
     {
-        vert = glm::vec3(trans * glm::vec4(vert, 1.0));
-    }
+        chunkBoxes[chunkId] = internal::transformAndComputeBoundingBox(vertices.data() + begin, end - begin, trans);
+    }, numThreads, PARALLEL_KERNELS_MIN_VERTICES);
 
-    computeBoundingBox();
+    mBBox = BoundingBox();
+    for(const BoundingBox& box : chunkBoxes) mBBox.addBoundingBox(box);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,603 @@
+#include "MyRender/utils/MeshBVH.h"
+#include <algorithm>
+#include "MyRender/utils/Parallel.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    constexpr uint32_t BVH_NUM_BINS = 16;
+    // Past this depth the nodes are split at the median, so the traversal stacks cannot overflow
+    constexpr uint32_t BVH_MAX_SAH_DEPTH = 32;
+    constexpr uint32_t BVH_STACK_SIZE = 96;
+    // Nodes with more triangles compute their bounds and bins in parallel
+    constexpr size_t BVH_PARALLEL_MIN_TRIANGLES = 1 << 16;
+    // Cost of a traversal step relative to a triangle test
+    constexpr float BVH_TRAVERSAL_COST = 1.0f;
+    // Smaller nodes are always leaves, splitting them is rarely worth the extra nodes
+    constexpr uint32_t BVH_MIN_SPLIT_TRIANGLES = 4;
+
+    inline float getHalfArea(const BoundingBox& box)
+    {
+        const glm::vec3 size = glm::max(box.getSize(), glm::vec3(0.0f));
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    struct BvhBuildItem
+    {
+        uint32_t node;
+        uint32_t first;
+        uint32_t count;
+        uint32_t depth;
+    };
+
+    // Triangle bounds, partitioned in place during the build so every pass reads them sequentially
+    struct BvhPrimitive
+    {
+        glm::vec3 min;
+        uint32_t triangle;
+        glm::vec3 max;
+        uint32_t padding;
+
+        glm::vec3 getCentroid() const { return 0.5f * (min + max); }
+    };
+
+    class BvhBuilder
+    {
+    public:
+        explicit BvhBuilder(std::vector<BvhPrimitive>& primitives)
+            : mPrimitives(primitives)
+        {}
+
+        // Sets the bounds of the node and makes it a leaf or splits it, appending the children to nodes and to the stack
+        void processNode(std::vector<MeshBVH::Node>& nodes, const BvhBuildItem& item, std::vector<BvhBuildItem>& stack, uint32_t numThreads)
+        {
+            BoundingBox box, centroidBox;
+            computeBounds(item.first, item.count, box, centroidBox, numThreads);
+            nodes[item.node].min = box.min;
+            nodes[item.node].max = box.max;
+
+            uint32_t leftCount = 0;
+            if(item.count > BVH_MIN_SPLIT_TRIANGLES)
+            {
+                leftCount = item.depth < BVH_MAX_SAH_DEPTH ? splitSah(item.first, item.count, box, centroidBox, numThreads) : 0;
+                if(leftCount == 0 && item.count > MeshBVH::MAX_LEAF_TRIANGLES) leftCount = splitMedian(item.first, item.count, centroidBox);
+            }
+
+            if(leftCount == 0)
+            {
+                nodes[item.node].firstChildOrTriangle = item.first;
+                nodes[item.node].numTriangles = item.count;
+                return;
+            }
+
+            const uint32_t left = static_cast<uint32_t>(nodes.size());
+            nodes.resize(nodes.size() + 2);
+            nodes[item.node].firstChildOrTriangle = left;
+            nodes[item.node].numTriangles = 0;
+            stack.push_back({left + 1, item.first + leftCount, item.count - leftCount, item.depth + 1});
+            stack.push_back({left, item.first, leftCount, item.depth + 1});
+        }
+
+    private:
+        struct Bin
+        {
+            BoundingBox box;
+            uint32_t count = 0;
+        };
+
+        // Bins of the three axes
+        struct BinSet
+        {
+            Bin bins[3 * BVH_NUM_BINS];
+        };
+
+        std::vector<BvhPrimitive>& mPrimitives;
+
+        static bool isParallel(uint32_t count, uint32_t numThreads)
+        {
+            return count >= BVH_PARALLEL_MIN_TRIANGLES && Parallel::getNumThreads(numThreads) > 1;
+        }
+
+        void computeBounds(uint32_t first, uint32_t count, BoundingBox& box, BoundingBox& centroidBox, uint32_t numThreads) const
+        {
+            auto accumulate = [&](size_t begin, size_t end, BoundingBox& chunkBox, BoundingBox& chunkCentroidBox)
+            {
+                for(size_t i = begin; i < end; i++)
+                {
+                    chunkBox.addBoundingBox(BoundingBox(mPrimitives[i].min, mPrimitives[i].max));
+                    chunkCentroidBox.addPoint(mPrimitives[i].getCentroid());
+                }
+            };
+
+            if(!isParallel(count, numThreads))
+            {
+                accumulate(first, first + count, box, centroidBox);
+                return;
+            }
+
+            std::vector<BoundingBox> boxes(2 * Parallel::getNumThreads(numThreads));
+            Parallel::forRange(first, first + count, [&](size_t begin, size_t end, uint32_t chunkId)
+            {
+                accumulate(begin, end, boxes[2 * chunkId], boxes[2 * chunkId + 1]);
+            }, numThreads, BVH_PARALLEL_MIN_TRIANGLES);
+
+            for(size_t c = 0; c < boxes.size(); c += 2)
+            {
+                box.addBoundingBox(boxes[c]);
+                centroidBox.addBoundingBox(boxes[c + 1]);
+            }
+        }
+
+        // Returns the number of triangles moved to the left child, or 0 when a leaf is cheaper or there is no split
+        uint32_t splitSah(uint32_t first, uint32_t count, const BoundingBox& box, const BoundingBox& centroidBox, uint32_t numThreads)
+        {
+            // Small nodes do not need as many bins, and most of the nodes are small
+            const uint32_t numBins = std::min(BVH_NUM_BINS, std::max(4u, count));
+            const glm::vec3 extent = centroidBox.getSize();
+            const glm::vec3 scale(extent.x > 0.0f ? numBins / extent.x : 0.0f,
+                                  extent.y > 0.0f ? numBins / extent.y : 0.0f,
+                                  extent.z > 0.0f ? numBins / extent.z : 0.0f);
+            auto getBin = [&](const glm::vec3& centroid, uint32_t axis)
+            {
+                return std::min(numBins - 1, static_cast<uint32_t>((centroid[axis] - centroidBox.min[axis]) * scale[axis]));
+            };
+            auto binPrimitives = [&](size_t begin, size_t end, BinSet& set)
+            {
+                for(size_t i = begin; i < end; i++)
+                {
+                    const BoundingBox primitiveBox(mPrimitives[i].min, mPrimitives[i].max);
+                    const glm::vec3 centroid = mPrimitives[i].getCentroid();
+                    for(uint32_t axis = 0; axis < 3; axis++)
+                    {
+                        Bin& bin = set.bins[axis * BVH_NUM_BINS + getBin(centroid, axis)];
+                        bin.box.addBoundingBox(primitiveBox);
+                        bin.count++;
+                    }
+                }
+            };
+
+            BinSet set;
+            if(!isParallel(count, numThreads)) binPrimitives(first, first + count, set);
+            else
+            {
+                std::vector<BinSet> chunkSets(Parallel::getNumThreads(numThreads));
+                Parallel::forRange(first, first + count, [&](size_t begin, size_t end, uint32_t chunkId)
+                {
+                    binPrimitives(begin, end, chunkSets[chunkId]);
+                }, numThreads, BVH_PARALLEL_MIN_TRIANGLES);
+
+                for(const BinSet& chunkSet : chunkSets)
+                {
+                    for(uint32_t b = 0; b < 3 * BVH_NUM_BINS; b++)
+                    {
+                        set.bins[b].box.addBoundingBox(chunkSet.bins[b].box);
+                        set.bins[b].count += chunkSet.bins[b].count;
+                    }
+                }
+            }
+
+            // Sweep from the right storing the cost of each right side, then from the left
+            float bestCost = static_cast<float>(count) * getHalfArea(box);
+            uint32_t bestAxis = 0, bestSplit = 0;
+            for(uint32_t axis = 0; axis < 3; axis++)
+            {
+                if(scale[axis] == 0.0f) continue;
+                const Bin* axisBins = &set.bins[axis * BVH_NUM_BINS];
+                float rightCosts[BVH_NUM_BINS];
+                BoundingBox rightBox;
+                uint32_t rightCount = 0;
+                for(uint32_t b = numBins - 1; b > 0; b--)
+                {
+                    rightBox.addBoundingBox(axisBins[b].box);
+                    rightCount += axisBins[b].count;
+                    rightCosts[b] = static_cast<float>(rightCount) * getHalfArea(rightBox);
+                }
+
+                BoundingBox leftBox;
+                uint32_t leftCount = 0;
+                for(uint32_t split = 1; split < numBins; split++)
+                {
+                    leftBox.addBoundingBox(axisBins[split - 1].box);
+                    leftCount += axisBins[split - 1].count;
+                    if(leftCount == 0 || leftCount == count) continue;
+                    const float cost = BVH_TRAVERSAL_COST * getHalfArea(box) + static_cast<float>(leftCount) * getHalfArea(leftBox) + rightCosts[split];
+                    if(cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+            if(bestSplit == 0) return 0;
+
+            const auto middle = std::partition(mPrimitives.begin() + first, mPrimitives.begin() + first + count, [&](const BvhPrimitive& primitive)
+            {
+                return getBin(primitive.getCentroid(), bestAxis) < bestSplit;
+            });
+            return static_cast<uint32_t>(middle - (mPrimitives.begin() + first));
+        }
+
+        uint32_t splitMedian(uint32_t first, uint32_t count, const BoundingBox& centroidBox)
+        {
+            const glm::vec3 extent = centroidBox.getSize();
+            const uint32_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+            const auto begin = mPrimitives.begin() + first;
+            std::nth_element(begin, begin + count / 2, begin + count, [&](const BvhPrimitive& a, const BvhPrimitive& b)
+            {
+                return a.min[axis] + a.max[axis] < b.min[axis] + b.max[axis];
+            });
+            return count / 2;
+        }
+    };
+
+    // Entry distance of the ray into the box, or FLT_MAX when it misses it within [tMin, tMax]
+    inline float intersectBox(const MeshBVH::Node& node, const glm::vec3& origin, const glm::vec3& invDirection, float tMin, float tMax)
+    {
+        const glm::vec3 t1 = (node.min - origin) * invDirection;
+        const glm::vec3 t2 = (node.max - origin) * invDirection;
+        const glm::vec3 tNear = glm::min(t1, t2);
+        const glm::vec3 tFar = glm::max(t1, t2);
+        const float entry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, tMin));
+        const float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, tMax));
+        return entry <= exit ? entry : FLT_MAX;
+    }
+
+    // Moller-Trumbore, both faces are hit
+    inline bool intersectTriangle(const Ray& ray, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
+                                  float tMax, float& t, glm::vec2& barycentric)
+    {
+        const glm::vec3 e1 = v1 - v0;
+        const glm::vec3 e2 = v2 - v0;
+        const glm::vec3 p = glm::cross(ray.direction, e2);
+        const float det = glm::dot(e1, p);
+        if(det == 0.0f) return false;
+        const float invDet = 1.0f / det;
+
+        const glm::vec3 s = ray.origin - v0;
+        const float u = glm::dot(s, p) * invDet;
+        if(u < 0.0f || u > 1.0f) return false;
+        const glm::vec3 q = glm::cross(s, e1);
+        const float v = glm::dot(ray.direction, q) * invDet;
+        if(v < 0.0f || u + v > 1.0f) return false;
+
+        t = glm::dot(e2, q) * invDet;
+        if(t < ray.tMin || t > tMax) return false;
+        barycentric = glm::vec2(u, v);
+        return true;
+    }
+
+    // From Real-Time Collision Detection, Ericson, 5.1.5
+    glm::vec3 closestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+    {
+        const glm::vec3 ab = b - a;
+        const glm::vec3 ac = c - a;
+        const glm::vec3 ap = p - a;
+        const float d1 = glm::dot(ab, ap);
+        const float d2 = glm::dot(ac, ap);
+        if(d1 <= 0.0f && d2 <= 0.0f) return a;
+
+        const glm::vec3 bp = p - b;
+        const float d3 = glm::dot(ab, bp);
+        const float d4 = glm::dot(ac, bp);
+        if(d3 >= 0.0f && d4 <= d3) return b;
+
+        const float vc = d1 * d4 - d3 * d2;
+        if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+        const glm::vec3 cp = p - c;
+        const float d5 = glm::dot(ab, cp);
+        const float d6 = glm::dot(ac, cp);
+        if(d6 >= 0.0f && d5 <= d6) return c;
+
+        const float vb = d5 * d2 - d1 * d6;
+        if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+        const float va = d3 * d6 - d5 * d4;
+        if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+        const float denom = 1.0f / (va + vb + vc);
+        return a + ab * (vb * denom) + ac * (vc * denom);
+    }
+
+    inline float getSquaredDistance(const MeshBVH::Node& node, const glm::vec3& p)
+    {
+        const glm::vec3 d = glm::max(glm::max(node.min - p, p - node.max), glm::vec3(0.0f));
+        return glm::dot(d, d);
+    }
+}
+
+void MeshBVH::build(const Mesh& mesh, uint32_t numThreads)
+{
+    using namespace internal;
+    mMesh = &mesh;
+    mNodes.clear();
+    mTriangles.clear();
+
+    const std::vector<glm::vec3>& vertices = mesh.getVertices();
+    const std::vector<uint32_t>& indices = mesh.getIndices();
+    const uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+    if(numTriangles == 0) return;
+
+    std::vector<BvhPrimitive> primitives(numTriangles);
+    Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t t = begin; t < end; t++)
+        {
+            BoundingBox box;
+            for(uint32_t k = 0; k < 3; k++) box.addPoint(vertices[indices[3 * t + k]]);
+            primitives[t] = {box.min, static_cast<uint32_t>(t), box.max, 0};
+        }
+    }, numThreads);
+
+    // The top of the tree is split first, binning each node in parallel, until there are enough subtrees
+    // to build each one in a single thread
+    const uint32_t threads = Parallel::getNumThreads(numThreads);
+    const uint32_t subtreeTriangles = threads > 1 ? std::max<uint32_t>(numTriangles / (4 * threads), 1024) : 0;
+
+    BvhBuilder builder(primitives);
+    mNodes.reserve(2 * static_cast<size_t>(numTriangles));
+    mNodes.resize(1);
+    std::vector<BvhBuildItem> stack = {{0, 0, numTriangles, 0}};
+    std::vector<BvhBuildItem> subtrees;
+    while(!stack.empty())
+    {
+        const BvhBuildItem item = stack.back();
+        stack.pop_back();
+        if(item.count < subtreeTriangles) subtrees.push_back(item);
+        else builder.processNode(mNodes, item, stack, numThreads);
+    }
+
+    // Each subtree is built in its own array with the root at 0 and appended afterwards
+    std::vector<std::vector<Node>> subtreeNodes(subtrees.size());
+    Parallel::forRange(0, subtrees.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        std::vector<BvhBuildItem> localStack;
+        for(size_t s = begin; s < end; s++)
+        {
+            std::vector<Node>& nodes = subtreeNodes[s];
+            nodes.resize(1);
+            localStack.push_back({0, subtrees[s].first, subtrees[s].count, subtrees[s].depth});
+            while(!localStack.empty())
+            {
+                const BvhBuildItem item = localStack.back();
+                localStack.pop_back();
+                builder.processNode(nodes, item, localStack, 1);
+            }
+        }
+    }, numThreads, 1);
+
+    for(size_t s = 0; s < subtrees.size(); s++)
+    {
+        const uint32_t offset = static_cast<uint32_t>(mNodes.size()) - 1;
+        for(Node& node : subtreeNodes[s])
+        {
+            if(!node.isLeaf()) node.firstChildOrTriangle += offset;
+        }
+        mNodes[subtrees[s].node] = subtreeNodes[s][0];
+        mNodes.insert(mNodes.end(), subtreeNodes[s].begin() + 1, subtreeNodes[s].end());
+    }
+    mNodes.shrink_to_fit();
+
+    mTriangles.resize(numTriangles);
+    Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t i = begin; i < end; i++) mTriangles[i] = primitives[i].triangle;
+    }, numThreads);
+}
+
+void MeshBVH::refit(uint32_t numThreads)
+{
+    if(mMesh == nullptr) return;
+    const std::vector<glm::vec3>& vertices = mMesh->getVertices();
+    const std::vector<uint32_t>& indices = mMesh->getIndices();
+
+    Parallel::forRange(0, mNodes.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t n = begin; n < end; n++)
+        {
+            Node& node = mNodes[n];
+            if(!node.isLeaf()) continue;
+            BoundingBox box;
+            for(uint32_t i = node.firstChildOrTriangle; i < node.firstChildOrTriangle + node.numTriangles; i++)
+            {
+                for(uint32_t k = 0; k < 3; k++) box.addPoint(vertices[indices[3 * mTriangles[i] + k]]);
+            }
+            node.min = box.min;
+            node.max = box.max;
+        }
+    }, numThreads);
+
+    // The children are always after their parent
+    for(size_t n = mNodes.size(); n-- > 0;)
+    {
+        Node& node = mNodes[n];
+        if(node.isLeaf()) continue;
+        const Node& left = mNodes[node.firstChildOrTriangle];
+        const Node& right = mNodes[node.firstChildOrTriangle + 1];
+        node.min = glm::min(left.min, right.min);
+        node.max = glm::max(left.max, right.max);
+    }
+}
+
+template<typename F>
+bool MeshBVH::traverse(const Ray& ray, F&& onHit) const
+{
+    using namespace internal;
+    if(mNodes.empty()) return false;
+    const std::vector<glm::vec3>& vertices = mMesh->getVertices();
+    const std::vector<uint32_t>& indices = mMesh->getIndices();
+    const glm::vec3 invDirection = 1.0f / ray.direction;
+
+    float tMax = ray.tMax;
+    bool found = false;
+    uint32_t stack[BVH_STACK_SIZE];
+    float stackEntry[BVH_STACK_SIZE];
+    uint32_t stackSize = 0;
+
+    const float rootEntry = intersectBox(mNodes[0], ray.origin, invDirection, ray.tMin, tMax);
+    if(rootEntry == FLT_MAX) return false;
+    stack[stackSize] = 0;
+    stackEntry[stackSize++] = rootEntry;
+
+    while(stackSize > 0)
+    {
+        stackSize--;
+        if(stackEntry[stackSize] > tMax) continue;
+        const Node& node = mNodes[stack[stackSize]];
+
+        if(node.isLeaf())
+        {
+            for(uint32_t i = node.firstChildOrTriangle; i < node.firstChildOrTriangle + node.numTriangles; i++)
+            {
+                const uint32_t t = mTriangles[i];
+                float distance;
+                glm::vec2 barycentric;
+                if(intersectTriangle(ray, vertices[indices[3 * t]], vertices[indices[3 * t + 1]], vertices[indices[3 * t + 2]],
+                                     tMax, distance, barycentric))
+                {
+                    found = true;
+                    RayHit hit;
+                    hit.triangle = t;
+                    hit.t = distance;
+                    hit.barycentric = barycentric;
+                    if(onHit(hit, tMax)) return true;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearest child first
+        const uint32_t left = node.firstChildOrTriangle;
+        float leftEntry = intersectBox(mNodes[left], ray.origin, invDirection, ray.tMin, tMax);
+        float rightEntry = intersectBox(mNodes[left + 1], ray.origin, invDirection, ray.tMin, tMax);
+        uint32_t near = left, far = left + 1;
+        if(rightEntry < leftEntry)
+        {
+            std::swap(near, far);
+            std::swap(leftEntry, rightEntry);
+        }
+        if(rightEntry != FLT_MAX)
+        {
+            stack[stackSize] = far;
+            stackEntry[stackSize++] = rightEntry;
+        }
+        if(leftEntry != FLT_MAX)
+        {
+            stack[stackSize] = near;
+            stackEntry[stackSize++] = leftEntry;
+        }
+    }
+    return found;
+}
+
+bool MeshBVH::intersect(const Ray& ray, RayHit& hit) const
+{
+    return traverse(ray, [&](const RayHit& newHit, float& tMax)
+    {
+        hit = newHit;
+        tMax = newHit.t;
+        return false;
+    });
+}
+
+bool MeshBVH::intersectAny(const Ray& ray) const
+{
+    return traverse(ray, [](const RayHit&, float&) { return true; });
+}
+
+size_t MeshBVH::intersectAll(const Ray& ray, std::vector<RayHit>& hits) const
+{
+    const size_t numHits = hits.size();
+    traverse(ray, [&](const RayHit& hit, float&)
+    {
+        hits.push_back(hit);
+        return false;
+    });
+    std::sort(hits.begin() + numHits, hits.end(), [](const RayHit& a, const RayHit& b) { return a.t < b.t; });
+    return hits.size() - numHits;
+}
+
+void MeshBVH::intersect(const std::vector<Ray>& rays, std::vector<RayHit>& hits, uint32_t numThreads) const
+{
+    hits.assign(rays.size(), RayHit());
+    Parallel::forRange(0, rays.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t r = begin; r < end; r++) intersect(rays[r], hits[r]);
+    }, numThreads, 256);
+}
+
+bool MeshBVH::findNearestPoint(const glm::vec3& point, NearestPoint& result, float maxDistance) const
+{
+    using namespace internal;
+    if(mNodes.empty()) return false;
+    const std::vector<glm::vec3>& vertices = mMesh->getVertices();
+    const std::vector<uint32_t>& indices = mMesh->getIndices();
+
+    float best = maxDistance < FLT_MAX ? maxDistance * maxDistance : FLT_MAX;
+    bool found = false;
+    uint32_t stack[BVH_STACK_SIZE];
+    float stackDistance[BVH_STACK_SIZE];
+    uint32_t stackSize = 0;
+    stack[stackSize] = 0;
+    stackDistance[stackSize++] = getSquaredDistance(mNodes[0], point);
+
+    while(stackSize > 0)
+    {
+        stackSize--;
+        if(stackDistance[stackSize] > best) continue;
+        const Node& node = mNodes[stack[stackSize]];
+
+        if(node.isLeaf())
+        {
+            for(uint32_t i = node.firstChildOrTriangle; i < node.firstChildOrTriangle + node.numTriangles; i++)
+            {
+                const uint32_t t = mTriangles[i];
+                const glm::vec3 closest = closestPointOnTriangle(point, vertices[indices[3 * t]], vertices[indices[3 * t + 1]],
+                                                                 vertices[indices[3 * t + 2]]);
+                const float distance = glm::dot(closest - point, closest - point);
+                if(distance <= best)
+                {
+                    best = distance;
+                    found = true;
+                    result.triangle = t;
+                    result.point = closest;
+                }
+            }
+            continue;
+        }
+
+        const uint32_t left = node.firstChildOrTriangle;
+        float nearDistance = getSquaredDistance(mNodes[left], point);
+        float farDistance = getSquaredDistance(mNodes[left + 1], point);
+        uint32_t near = left, far = left + 1;
+        if(farDistance < nearDistance)
+        {
+            std::swap(near, far);
+            std::swap(nearDistance, farDistance);
+        }
+        if(farDistance <= best)
+        {
+            stack[stackSize] = far;
+            stackDistance[stackSize++] = farDistance;
+        }
+        if(nearDistance <= best)
+        {
+            stack[stackSize] = near;
+            stackDistance[stackSize++] = nearDistance;
+        }
+    }
+
+    if(found) result.distance = glm::sqrt(best);
+    return found;
+}
+
+BoundingBox MeshBVH::getBoundingBox() const
+{
+    if(mNodes.empty()) return BoundingBox();
+    return BoundingBox(mNodes[0].min, mNodes[0].max);
+}
+
+}
@@ -0,0 +1,232 @@
+#include "MyRender/utils/MeshFile.h"
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+namespace myrender
+{
+
+namespace internal
+{
+    struct SectionData
+    {
+        MeshFile::SectionType type;
+        uint32_t elementSize;
+        uint64_t numElements;
+        std::vector<const void*> chunks; // Written one after the other
+        std::vector<uint64_t> chunkSizes;
+    };
+
+    uint64_t alignSectionOffset(uint64_t offset)
+    {
+        return (offset + MeshFile::SECTION_ALIGNMENT - 1) / MeshFile::SECTION_ALIGNMENT * MeshFile::SECTION_ALIGNMENT;
+    }
+}
+
+bool MeshFile::write(const std::string& path, const Mesh& mesh, const std::vector<MeshSimplifier::MeshLod>& lods)
+{
+    using internal::SectionData;
+    std::vector<SectionData> sections;
+
+    const std::vector<glm::vec3>& vertices = mesh.getVertices();
+    sections.push_back({SectionType::POSITIONS, sizeof(glm::vec3), vertices.size(), {vertices.data()}, {vertices.size() * sizeof(glm::vec3)}});
+
+    if(mesh.getNormals().size() == vertices.size())
+    {
+        const std::vector<glm::vec3>& normals = mesh.getNormals();
+        sections.push_back({SectionType::NORMALS, sizeof(glm::vec3), normals.size(), {normals.data()}, {normals.size() * sizeof(glm::vec3)}});
+    }
+
+    // Computed from the positions, since the box of the mesh may not have been
+    std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(0));
+    Parallel::forRange(0, vertices.size(), [&](size_t begin, size_t end, uint32_t chunkId)
+    {
+        chunkBoxes[chunkId] = internal::computeBoundingBox(vertices.data() + begin, end - begin);
+    }, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+    BoundingBox box;
+    for(const BoundingBox& chunkBox : chunkBoxes) box.addBoundingBox(chunkBox);
+    sections.push_back({SectionType::BOUNDS, sizeof(BoundingBox), 1, {&box}, {sizeof(BoundingBox)}});
+
+    // Without lods the indices are the mesh ones, otherwise all the levels are stored together
+    std::vector<LodRange> ranges;
+    SectionData indices = {SectionType::INDICES, sizeof(uint32_t), 0, {}, {}};
+    if(lods.empty())
+    {
+        indices.numElements = mesh.getIndices().size();
+        indices.chunks.push_back(mesh.getIndices().data());
+        indices.chunkSizes.push_back(mesh.getIndices().size() * sizeof(uint32_t));
+    }
+    else
+    {
+        for(const MeshSimplifier::MeshLod& lod : lods)
+        {
+            ranges.push_back({indices.numElements, lod.indices.size(), lod.error, 0});
+            indices.numElements += lod.indices.size();
+            indices.chunks.push_back(lod.indices.data());
+            indices.chunkSizes.push_back(lod.indices.size() * sizeof(uint32_t));
+        }
+        sections.push_back({SectionType::LOD_RANGES, sizeof(LodRange), ranges.size(), {ranges.data()}, {ranges.size() * sizeof(LodRange)}});
+    }
+    sections.push_back(indices);
+
+    // Layout
+    Header header = {MAGIC, VERSION, static_cast<uint32_t>(sections.size()), 0, 0};
+    std::vector<Section> table;
+    uint64_t offset = sizeof(Header) + sections.size() * sizeof(Section);
+    for(const SectionData& section : sections)
+    {
+        offset = internal::alignSectionOffset(offset);
+        table.push_back({static_cast<uint32_t>(section.type), section.elementSize, offset, section.numElements});
+        offset += section.numElements * section.elementSize;
+    }
+    header.fileSize = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        std::cout << "Error: the file " << path << " could not be opened for writing" << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(Section));
+    uint64_t position = sizeof(Header) + table.size() * sizeof(Section);
+    const char padding[SECTION_ALIGNMENT] = {};
+    for(size_t s = 0; s < sections.size(); s++)
+    {
+        file.write(padding, table[s].offset - position);
+        for(size_t c = 0; c < sections[s].chunks.size(); c++)
+        {
+            file.write(reinterpret_cast<const char*>(sections[s].chunks[c]), sections[s].chunkSizes[c]);
+        }
+        position = table[s].offset + sections[s].numElements * sections[s].elementSize;
+    }
+
+    if(!file.good())
+    {
+        std::cout << "Error: the file " << path << " could not be written" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MappedMesh::open(const std::string& path)
+{
+    close();
+    if(!mFile.open(path))
+    {
+        std::cout << "Error: the file " << path << " could not be mapped" << std::endl;
+        return false;
+    }
+
+    auto fail = [&](const char* reason)
+    {
+        std::cout << "Error: " << path << " is not a valid mesh file, " << reason << std::endl;
+        close();
+        return false;
+    };
+
+    const uint8_t* fileData = mFile.getData();
+    const size_t fileSize = mFile.getSize();
+    if(fileSize < sizeof(MeshFile::Header)) return fail("it is too small");
+    MeshFile::Header header;
+    std::memcpy(&header, fileData, sizeof(MeshFile::Header));
+    if(header.magic != MeshFile::MAGIC) return fail("wrong magic number");
+    if(header.version > MeshFile::VERSION) return fail("unsupported version");
+    if(header.fileSize > fileSize) return fail("it is truncated");
+    if(sizeof(MeshFile::Header) + static_cast<uint64_t>(header.numSections) * sizeof(MeshFile::Section) > fileSize)
+    {
+        return fail("the section table is truncated");
+    }
+
+    size_t numNormals = 0;
+    const MeshFile::Section* table = reinterpret_cast<const MeshFile::Section*>(fileData + sizeof(MeshFile::Header));
+    for(uint32_t s = 0; s < header.numSections; s++)
+    {
+        const MeshFile::Section& section = table[s];
+        if(section.offset % MeshFile::SECTION_ALIGNMENT != 0) return fail("misaligned section");
+        // Written with divisions, so crafted sizes cannot wrap around
+        if(section.offset > fileSize) return fail("section out of the file");
+        if(section.elementSize > 0 && section.numElements > (fileSize - section.offset) / section.elementSize)
+        {
+            return fail("section out of the file");
+        }
+        const uint8_t* data = fileData + section.offset;
+
+        switch(static_cast<MeshFile::SectionType>(section.type))
+        {
+            case MeshFile::SectionType::POSITIONS:
+                if(section.elementSize != sizeof(glm::vec3)) return fail("wrong position size");
+                mVertices = reinterpret_cast<const glm::vec3*>(data);
+                mNumVertices = section.numElements;
+                break;
+            case MeshFile::SectionType::NORMALS:
+                if(section.elementSize != sizeof(glm::vec3)) return fail("wrong normal size");
+                mNormals = reinterpret_cast<const glm::vec3*>(data);
+                numNormals = section.numElements;
+                break;
+            case MeshFile::SectionType::INDICES:
+                if(section.elementSize != sizeof(uint32_t)) return fail("wrong index size");
+                mIndices = reinterpret_cast<const uint32_t*>(data);
+                mNumAllIndices = section.numElements;
+                break;
+            case MeshFile::SectionType::BOUNDS:
+                if(section.elementSize != sizeof(BoundingBox) || section.numElements != 1) return fail("wrong bounds");
+                std::memcpy(&mBBox, data, sizeof(BoundingBox));
+                break;
+            case MeshFile::SectionType::LOD_RANGES:
+                if(section.elementSize != sizeof(MeshFile::LodRange)) return fail("wrong lod size");
+                mLods.resize(section.numElements);
+                std::memcpy(mLods.data(), data, section.numElements * sizeof(MeshFile::LodRange));
+                break;
+            default:
+                break;
+        }
+    }
+
+    if(mNormals != nullptr && numNormals != mNumVertices) return fail("the number of normals does not match the vertices");
+    for(const MeshFile::LodRange& lod : mLods)
+    {
+        if(lod.firstIndex > mNumAllIndices || lod.numIndices > mNumAllIndices - lod.firstIndex) return fail("lod out of the indices");
+    }
+
+    // Every consumer indexes the vertices with them, so they are checked once here. This reads the whole
+    // index section, the vertices are still read on first access
+    std::atomic<bool> validIndices(true);
+    Parallel::forRange(0, mNumAllIndices, [&](size_t begin, size_t end, uint32_t)
+    {
+        uint32_t maxIndex = 0;
+        for(size_t i = begin; i < end; i++) maxIndex = std::max(maxIndex, mIndices[i]);
+        if(end > begin && maxIndex >= mNumVertices) validIndices = false;
+    }, 0, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+    if(!validIndices) return fail("index out of the vertices");
+    return true;
+}
+
+void MappedMesh::close()
+{
+    mFile.close();
+    mVertices = nullptr;
+    mNormals = nullptr;
+    mNumVertices = 0;
+    mIndices = nullptr;
+    mNumAllIndices = 0;
+    mBBox = BoundingBox();
+    mLods.clear();
+}
+
+Mesh MappedMesh::toMesh() const
+{
+    Mesh mesh;
+    mesh.mVertices.rewrite().assign(mVertices, mVertices + mNumVertices);
+    if(mNormals != nullptr) mesh.mNormals.rewrite().assign(mNormals, mNormals + mNumVertices);
+    mesh.mIndices.rewrite().assign(mIndices, mIndices + getNumIndices());
+    mesh.mBBox = mBBox;
+    return mesh;
+}
+
+}
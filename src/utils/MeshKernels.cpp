@@ -0,0 +1,773 @@
+#include "utils/MeshKernels.h"
+#include "MyRender/utils/Simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MYRENDER_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MYRENDER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MYRENDER_TARGET_AVX2
+#endif
+
+namespace myrender
+{
+
+namespace internal
+{
+
+// Scalar kernels, also used for the tails of the vectorized ones
+BoundingBox computeBoundingBoxScalar(const glm::vec3* vertices, size_t numVertices)
+{
+    BoundingBox box;
+    for(size_t i = 0; i < numVertices; i++)
+    {
+        box.addPoint(vertices[i]);
+    }
+    return box;
+}
+
+BoundingBox transformAndComputeBoundingBoxScalar(glm::vec3* vertices, size_t numVertices, const glm::mat4& trans)
+{
+    BoundingBox box;
+    for(size_t i = 0; i < numVertices; i++)
+    {
+        const glm::vec3 v = vertices[i];
+        const glm::vec3 res((trans[0][0] * v.x + trans[1][0] * v.y) + (trans[2][0] * v.z + trans[3][0]),
+                            (trans[0][1] * v.x + trans[1][1] * v.y) + (trans[2][1] * v.z + trans[3][1]),
+                            (trans[0][2] * v.x + trans[1][2] * v.y) + (trans[2][2] * v.z + trans[3][2]));
+        vertices[i] = res;
+        box.addPoint(res);
+    }
+    return box;
+}
+
+BoundingBox computeBoundingBoxScalar(const float* x, const float* y, const float* z, size_t numVertices)
+{
+    BoundingBox box;
+    for(size_t i = 0; i < numVertices; i++)
+    {
+        box.addPoint(glm::vec3(x[i], y[i], z[i]));
+    }
+    return box;
+}
+
+BoundingBox transformAndComputeBoundingBoxScalar(float* x, float* y, float* z, size_t numVertices, const glm::mat4& trans)
+{
+    BoundingBox box;
+    for(size_t i = 0; i < numVertices; i++)
+    {
+        const glm::vec3 v(x[i], y[i], z[i]);
+        x[i] = (trans[0][0] * v.x + trans[1][0] * v.y) + (trans[2][0] * v.z + trans[3][0]);
+        y[i] = (trans[0][1] * v.x + trans[1][1] * v.y) + (trans[2][1] * v.z + trans[3][1]);
+        z[i] = (trans[0][2] * v.x + trans[1][2] * v.y) + (trans[2][2] * v.z + trans[3][2]);
+        box.addPoint(glm::vec3(x[i], y[i], z[i]));
+    }
+    return box;
+}
+
+void deinterleaveScalar(const glm::vec3* src, size_t numVertices, float* x, float* y, float* z)
+{
+    for(size_t i = 0; i < numVertices; i++)
+    {
+        x[i] = src[i].x;
+        y[i] = src[i].y;
+        z[i] = src[i].z;
+    }
+}
+
+void interleaveScalar(const float* x, const float* y, const float* z, size_t numVertices, glm::vec3* dst)
+{
+    for(size_t i = 0; i < numVertices; i++)
+    {
+        dst[i] = glm::vec3(x[i], y[i], z[i]);
+    }
+}
+
+uint32_t computeMaxIndexScalar(const uint32_t* indices, size_t numIndices)
+{
+    uint32_t maxIndex = 0;
+    for(size_t i = 0; i < numIndices; i++) maxIndex = glm::max(maxIndex, indices[i]);
+    return maxIndex;
+}
+
+template<typename T>
+void narrowIndicesScalar(const uint32_t* src, size_t numIndices, T* dst)
+{
+    for(size_t i = 0; i < numIndices; i++) dst[i] = static_cast<T>(src[i]);
+}
+
+#ifdef MYRENDER_SIMD_X86
+
+// The vertices are packed as x0 y0 z0 x1 y1 z1 ..., so in a block of 12 floats (or 24 with AVX)
+// the float k always holds the component k % 3. The bounds are accumulated per float and reduced at the end.
+BoundingBox reduceInterleavedBounds(const float* mins, const float* maxs, uint32_t numFloats)
+{
+    BoundingBox box;
+    for(uint32_t k = 0; k < numFloats; k++)
+    {
+        box.min[k % 3] = glm::min(box.min[k % 3], mins[k]);
+        box.max[k % 3] = glm::max(box.max[k % 3], maxs[k]);
+    }
+    return box;
+}
+
+// Converts 4 interleaved vertices (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) to one register per component
+inline void deinterleaveSse(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z)
+{
+    const __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+    const __m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+    x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(ab, bc, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm_shuffle_ps(ab, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+inline void interleaveSse(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b, __m128& c)
+{
+    const __m128 xy01 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m128 zx01 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m128 yz12 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(2, 1, 2, 1));
+    const __m128 xy23 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m128 zx23 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m128 yz33 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(3, 0, 2, 0));
+    b = _mm_shuffle_ps(yz12, xy23, _MM_SHUFFLE(2, 0, 2, 0));
+    c = _mm_shuffle_ps(zx23, yz33, _MM_SHUFFLE(2, 0, 3, 0));
+}
+
+inline float reduceMinSse(__m128 v)
+{
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+inline float reduceMaxSse(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+BoundingBox computeBoundingBoxSse(const glm::vec3* vertices, size_t numVertices)
+{
+    const float* data = reinterpret_cast<const float*>(vertices);
+    const size_t numBlocks = numVertices / 4;
+
+    __m128 min[3], max[3];
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        min[i] = _mm_set1_ps(INFINITY);
+        max[i] = _mm_set1_ps(-INFINITY);
+    }
+
+    for(size_t b = 0; b < numBlocks; b++, data += 12)
+    {
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            const __m128 v = _mm_loadu_ps(data + 4 * i);
+            min[i] = _mm_min_ps(min[i], v);
+            max[i] = _mm_max_ps(max[i], v);
+        }
+    }
+
+    float mins[12], maxs[12];
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        _mm_storeu_ps(mins + 4 * i, min[i]);
+        _mm_storeu_ps(maxs + 4 * i, max[i]);
+    }
+
+    BoundingBox box = reduceInterleavedBounds(mins, maxs, 12);
+    box.addBoundingBox(computeBoundingBoxScalar(vertices + 4 * numBlocks, numVertices - 4 * numBlocks));
+    return box;
+}
+
+BoundingBox transformAndComputeBoundingBoxSse(glm::vec3* vertices, size_t numVertices, const glm::mat4& trans)
+{
+    float* data = reinterpret_cast<float*>(vertices);
+    const size_t numBlocks = numVertices / 4;
+
+    __m128 m[4][3];
+    for(uint32_t c = 0; c < 4; c++)
+    {
+        for(uint32_t r = 0; r < 3; r++) m[c][r] = _mm_set1_ps(trans[c][r]);
+    }
+
+    __m128 min[3], max[3];
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        min[i] = _mm_set1_ps(INFINITY);
+        max[i] = _mm_set1_ps(-INFINITY);
+    }
+
+    for(size_t b = 0; b < numBlocks; b++, data += 12)
+    {
+        __m128 x, y, z;
+        deinterleaveSse(_mm_loadu_ps(data), _mm_loadu_ps(data + 4), _mm_loadu_ps(data + 8), x, y, z);
+
+        // Same operation order as the scalar path, so both give the same result
+        __m128 res[3];
+        for(uint32_t r = 0; r < 3; r++)
+        {
+            res[r] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][r], x), _mm_mul_ps(m[1][r], y)),
+                                _mm_add_ps(_mm_mul_ps(m[2][r], z), m[3][r]));
+            min[r] = _mm_min_ps(min[r], res[r]);
+            max[r] = _mm_max_ps(max[r], res[r]);
+        }
+
+        __m128 a, bb, c;
+        interleaveSse(res[0], res[1], res[2], a, bb, c);
+        _mm_storeu_ps(data, a);
+        _mm_storeu_ps(data + 4, bb);
+        _mm_storeu_ps(data + 8, c);
+    }
+
+    BoundingBox box(glm::vec3(reduceMinSse(min[0]), reduceMinSse(min[1]), reduceMinSse(min[2])),
+                    glm::vec3(reduceMaxSse(max[0]), reduceMaxSse(max[1]), reduceMaxSse(max[2])));
+    box.addBoundingBox(transformAndComputeBoundingBoxScalar(vertices + 4 * numBlocks, numVertices - 4 * numBlocks, trans));
+    return box;
+}
+
+// Structure of arrays kernels
+BoundingBox computeBoundingBoxSse(const float* x, const float* y, const float* z, size_t numVertices)
+{
+    const size_t numSimd = numVertices - numVertices % 4;
+    const float* data[3] = {x, y, z};
+
+    __m128 min[3], max[3];
+    for(uint32_t c = 0; c < 3; c++)
+    {
+        min[c] = _mm_set1_ps(INFINITY);
+        max[c] = _mm_set1_ps(-INFINITY);
+    }
+
+    for(size_t i = 0; i < numSimd; i += 4)
+    {
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            const __m128 v = _mm_loadu_ps(data[c] + i);
+            min[c] = _mm_min_ps(min[c], v);
+            max[c] = _mm_max_ps(max[c], v);
+        }
+    }
+
+    BoundingBox box(glm::vec3(reduceMinSse(min[0]), reduceMinSse(min[1]), reduceMinSse(min[2])),
+                    glm::vec3(reduceMaxSse(max[0]), reduceMaxSse(max[1]), reduceMaxSse(max[2])));
+    box.addBoundingBox(computeBoundingBoxScalar(x + numSimd, y + numSimd, z + numSimd, numVertices - numSimd));
+    return box;
+}
+
+BoundingBox transformAndComputeBoundingBoxSse(float* x, float* y, float* z, size_t numVertices, const glm::mat4& trans)
+{
+    const size_t numSimd = numVertices - numVertices % 4;
+    float* data[3] = {x, y, z};
+
+    __m128 m[4][3];
+    for(uint32_t c = 0; c < 4; c++)
+    {
+        for(uint32_t r = 0; r < 3; r++) m[c][r] = _mm_set1_ps(trans[c][r]);
+    }
+
+    __m128 min[3], max[3];
+    for(uint32_t c = 0; c < 3; c++)
+    {
+        min[c] = _mm_set1_ps(INFINITY);
+        max[c] = _mm_set1_ps(-INFINITY);
+    }
+
+    for(size_t i = 0; i < numSimd; i += 4)
+    {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = _mm_loadu_ps(y + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+        for(uint32_t r = 0; r < 3; r++)
+        {
+            const __m128 res = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][r], vx), _mm_mul_ps(m[1][r], vy)),
+                                          _mm_add_ps(_mm_mul_ps(m[2][r], vz), m[3][r]));
+            min[r] = _mm_min_ps(min[r], res);
+            max[r] = _mm_max_ps(max[r], res);
+            _mm_storeu_ps(data[r] + i, res);
+        }
+    }
+
+    BoundingBox box(glm::vec3(reduceMinSse(min[0]), reduceMinSse(min[1]), reduceMinSse(min[2])),
+                    glm::vec3(reduceMaxSse(max[0]), reduceMaxSse(max[1]), reduceMaxSse(max[2])));
+    box.addBoundingBox(transformAndComputeBoundingBoxScalar(x + numSimd, y + numSimd, z + numSimd, numVertices - numSimd, trans));
+    return box;
+}
+
+void deinterleaveSse(const glm::vec3* src, size_t numVertices, float* x, float* y, float* z)
+{
+    const size_t numSimd = numVertices - numVertices % 4;
+    const float* data = reinterpret_cast<const float*>(src);
+    for(size_t i = 0; i < numSimd; i += 4, data += 12)
+    {
+        __m128 vx, vy, vz;
+        deinterleaveSse(_mm_loadu_ps(data), _mm_loadu_ps(data + 4), _mm_loadu_ps(data + 8), vx, vy, vz);
+        _mm_storeu_ps(x + i, vx);
+        _mm_storeu_ps(y + i, vy);
+        _mm_storeu_ps(z + i, vz);
+    }
+    deinterleaveScalar(src + numSimd, numVertices - numSimd, x + numSimd, y + numSimd, z + numSimd);
+}
+
+void interleaveSse(const float* x, const float* y, const float* z, size_t numVertices, glm::vec3* dst)
+{
+    const size_t numSimd = numVertices - numVertices % 4;
+    float* data = reinterpret_cast<float*>(dst);
+    for(size_t i = 0; i < numSimd; i += 4, data += 12)
+    {
+        __m128 a, b, c;
+        interleaveSse(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(z + i), a, b, c);
+        _mm_storeu_ps(data, a);
+        _mm_storeu_ps(data + 4, b);
+        _mm_storeu_ps(data + 8, c);
+    }
+    interleaveScalar(x + numSimd, y + numSimd, z + numSimd, numVertices - numSimd, dst + numSimd);
+}
+
+// SSE2 has neither unsigned 32 bit comparisons nor unsigned packs. Flipping the sign bit orders
+// the indices as signed integers, and the indices that fit in 16 bits are sign extended before the
+// signed pack so it does not saturate
+uint32_t computeMaxIndexSse(const uint32_t* indices, size_t numIndices)
+{
+    const size_t numSimd = numIndices - numIndices % 4;
+    const __m128i signBit = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    __m128i maxIndex = signBit;
+    for(size_t i = 0; i < numSimd; i += 4)
+    {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), signBit);
+        const __m128i greater = _mm_cmpgt_epi32(v, maxIndex);
+        maxIndex = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, maxIndex));
+    }
+
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(maxIndex, signBit));
+    const uint32_t result = glm::max(glm::max(lanes[0], lanes[1]), glm::max(lanes[2], lanes[3]));
+    return glm::max(result, computeMaxIndexScalar(indices + numSimd, numIndices - numSimd));
+}
+
+inline __m128i narrowToShortsSse(const uint32_t* src)
+{
+    const __m128i a = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), 16), 16);
+    const __m128i b = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4)), 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+void narrowIndicesSse(const uint32_t* src, size_t numIndices, uint16_t* dst)
+{
+    const size_t numSimd = numIndices - numIndices % 8;
+    for(size_t i = 0; i < numSimd; i += 8)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), narrowToShortsSse(src + i));
+    }
+    narrowIndicesScalar(src + numSimd, numIndices - numSimd, dst + numSimd);
+}
+
+void narrowIndicesSse(const uint32_t* src, size_t numIndices, uint8_t* dst)
+{
+    const size_t numSimd = numIndices - numIndices % 16;
+    for(size_t i = 0; i < numSimd; i += 16)
+    {
+        const __m128i bytes = _mm_packus_epi16(narrowToShortsSse(src + i), narrowToShortsSse(src + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+    narrowIndicesScalar(src + numSimd, numIndices - numSimd, dst + numSimd);
+}
+
+// AVX2 kernels. The 256 bit shuffles work per 128 bit lane, so loading vertices 0-3 in the
+// low lane and vertices 4-7 in the high lane allows reusing the SSE shuffle patterns
+MYRENDER_TARGET_AVX2 inline __m256 loadLanesAvx(const float* low, const float* high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+MYRENDER_TARGET_AVX2 inline void storeLanesAvx(float* low, float* high, __m256 v)
+{
+    _mm_storeu_ps(low, _mm256_castps256_ps128(v));
+    _mm_storeu_ps(high, _mm256_extractf128_ps(v, 1));
+}
+
+// Loads 8 interleaved vertices as one register per component
+MYRENDER_TARGET_AVX2 inline void loadDeinterleavedAvx(const float* data, __m256& x, __m256& y, __m256& z)
+{
+    const __m256 a = loadLanesAvx(data, data + 12);
+    const __m256 b = loadLanesAvx(data + 4, data + 16);
+    const __m256 c = loadLanesAvx(data + 8, data + 20);
+
+    const __m256 ab = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+    const __m256 bc = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+    x = _mm256_shuffle_ps(a, bc, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm256_shuffle_ps(ab, bc, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm256_shuffle_ps(ab, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+MYRENDER_TARGET_AVX2 inline void storeInterleavedAvx(float* data, __m256 x, __m256 y, __m256 z)
+{
+    const __m256 xy01 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 zx01 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 yz12 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(2, 1, 2, 1));
+    const __m256 xy23 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 zx23 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 yz33 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+    storeLanesAvx(data, data + 12, _mm256_shuffle_ps(xy01, zx01, _MM_SHUFFLE(3, 0, 2, 0)));
+    storeLanesAvx(data + 4, data + 16, _mm256_shuffle_ps(yz12, xy23, _MM_SHUFFLE(2, 0, 2, 0)));
+    storeLanesAvx(data + 8, data + 20, _mm256_shuffle_ps(zx23, yz33, _MM_SHUFFLE(2, 0, 3, 0)));
+}
+
+MYRENDER_TARGET_AVX2 BoundingBox computeBoundingBoxAvx2(const glm::vec3* vertices, size_t numVertices)
+{
+    const float* data = reinterpret_cast<const float*>(vertices);
+    const size_t numBlocks = numVertices / 8;
+
+    __m256 min[3], max[3];
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        min[i] = _mm256_set1_ps(INFINITY);
+        max[i] = _mm256_set1_ps(-INFINITY);
+    }
+
+    for(size_t b = 0; b < numBlocks; b++, data += 24)
+    {
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            const __m256 v = _mm256_loadu_ps(data + 8 * i);
+            min[i] = _mm256_min_ps(min[i], v);
+            max[i] = _mm256_max_ps(max[i], v);
+        }
+    }
+
+    float mins[24], maxs[24];
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        _mm256_storeu_ps(mins + 8 * i, min[i]);
+        _mm256_storeu_ps(maxs + 8 * i, max[i]);
+    }
+
+    BoundingBox box = reduceInterleavedBounds(mins, maxs, 24);
+    box.addBoundingBox(computeBoundingBoxScalar(vertices + 8 * numBlocks, numVertices - 8 * numBlocks));
+    return box;
+}
+
+MYRENDER_TARGET_AVX2 BoundingBox transformAndComputeBoundingBoxAvx2(glm::vec3* vertices, size_t numVertices, const glm::mat4& trans)
+{
+    float* data = reinterpret_cast<float*>(vertices);
+    const size_t numBlocks = numVertices / 8;
+
+    __m256 m[4][3];
+    for(uint32_t c = 0; c < 4; c++)
+    {
+        for(uint32_t r = 0; r < 3; r++) m[c][r] = _mm256_set1_ps(trans[c][r]);
+    }
+
+    __m256 min[3], max[3];
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        min[i] = _mm256_set1_ps(INFINITY);
+        max[i] = _mm256_set1_ps(-INFINITY);
+    }
+
+    for(size_t b = 0; b < numBlocks; b++, data += 24)
+    {
+        __m256 x, y, z;
+        loadDeinterleavedAvx(data, x, y, z);
+
+        // No FMA, to keep the results equal to the other paths
+        __m256 res[3];
+        for(uint32_t r = 0; r < 3; r++)
+        {
+            res[r] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[0][r], x), _mm256_mul_ps(m[1][r], y)),
+                                   _mm256_add_ps(_mm256_mul_ps(m[2][r], z), m[3][r]));
+            min[r] = _mm256_min_ps(min[r], res[r]);
+            max[r] = _mm256_max_ps(max[r], res[r]);
+        }
+
+        storeInterleavedAvx(data, res[0], res[1], res[2]);
+    }
+
+    float mins[24], maxs[24];
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        _mm256_storeu_ps(mins + 8 * i, min[i]);
+        _mm256_storeu_ps(maxs + 8 * i, max[i]);
+    }
+
+    // Here the registers are already split by component
+    BoundingBox box;
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        for(uint32_t k = 0; k < 8; k++)
+        {
+            box.min[i] = glm::min(box.min[i], mins[8 * i + k]);
+            box.max[i] = glm::max(box.max[i], maxs[8 * i + k]);
+        }
+    }
+    box.addBoundingBox(transformAndComputeBoundingBoxScalar(vertices + 8 * numBlocks, numVertices - 8 * numBlocks, trans));
+    return box;
+}
+
+MYRENDER_TARGET_AVX2 inline float reduceMinAvx(__m256 v)
+{
+    return reduceMinSse(_mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+MYRENDER_TARGET_AVX2 inline float reduceMaxAvx(__m256 v)
+{
+    return reduceMaxSse(_mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+MYRENDER_TARGET_AVX2 BoundingBox computeBoundingBoxAvx2(const float* x, const float* y, const float* z, size_t numVertices)
+{
+    const size_t numSimd = numVertices - numVertices % 8;
+    const float* data[3] = {x, y, z};
+
+    __m256 min[3], max[3];
+    for(uint32_t c = 0; c < 3; c++)
+    {
+        min[c] = _mm256_set1_ps(INFINITY);
+        max[c] = _mm256_set1_ps(-INFINITY);
+    }
+
+    for(size_t i = 0; i < numSimd; i += 8)
+    {
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            const __m256 v = _mm256_loadu_ps(data[c] + i);
+            min[c] = _mm256_min_ps(min[c], v);
+            max[c] = _mm256_max_ps(max[c], v);
+        }
+    }
+
+    BoundingBox box(glm::vec3(reduceMinAvx(min[0]), reduceMinAvx(min[1]), reduceMinAvx(min[2])),
+                    glm::vec3(reduceMaxAvx(max[0]), reduceMaxAvx(max[1]), reduceMaxAvx(max[2])));
+    box.addBoundingBox(computeBoundingBoxScalar(x + numSimd, y + numSimd, z + numSimd, numVertices - numSimd));
+    return box;
+}
+
+MYRENDER_TARGET_AVX2 BoundingBox transformAndComputeBoundingBoxAvx2(float* x, float* y, float* z, size_t numVertices, const glm::mat4& trans)
+{
+    const size_t numSimd = numVertices - numVertices % 8;
+    float* data[3] = {x, y, z};
+
+    __m256 m[4][3];
+    for(uint32_t c = 0; c < 4; c++)
+    {
+        for(uint32_t r = 0; r < 3; r++) m[c][r] = _mm256_set1_ps(trans[c][r]);
+    }
+
+    __m256 min[3], max[3];
+    for(uint32_t c = 0; c < 3; c++)
+    {
+        min[c] = _mm256_set1_ps(INFINITY);
+        max[c] = _mm256_set1_ps(-INFINITY);
+    }
+
+    for(size_t i = 0; i < numSimd; i += 8)
+    {
+        const __m256 vx = _mm256_loadu_ps(x + i);
+        const __m256 vy = _mm256_loadu_ps(y + i);
+        const __m256 vz = _mm256_loadu_ps(z + i);
+        for(uint32_t r = 0; r < 3; r++)
+        {
+            const __m256 res = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[0][r], vx), _mm256_mul_ps(m[1][r], vy)),
+                                             _mm256_add_ps(_mm256_mul_ps(m[2][r], vz), m[3][r]));
+            min[r] = _mm256_min_ps(min[r], res);
+            max[r] = _mm256_max_ps(max[r], res);
+            _mm256_storeu_ps(data[r] + i, res);
+        }
+    }
+
+    BoundingBox box(glm::vec3(reduceMinAvx(min[0]), reduceMinAvx(min[1]), reduceMinAvx(min[2])),
+                    glm::vec3(reduceMaxAvx(max[0]), reduceMaxAvx(max[1]), reduceMaxAvx(max[2])));
+    box.addBoundingBox(transformAndComputeBoundingBoxScalar(x + numSimd, y + numSimd, z + numSimd, numVertices - numSimd, trans));
+    return box;
+}
+
+MYRENDER_TARGET_AVX2 void deinterleaveAvx2(const glm::vec3* src, size_t numVertices, float* x, float* y, float* z)
+{
+    const size_t numSimd = numVertices - numVertices % 8;
+    const float* data = reinterpret_cast<const float*>(src);
+    for(size_t i = 0; i < numSimd; i += 8, data += 24)
+    {
+        __m256 vx, vy, vz;
+        loadDeinterleavedAvx(data, vx, vy, vz);
+        _mm256_storeu_ps(x + i, vx);
+        _mm256_storeu_ps(y + i, vy);
+        _mm256_storeu_ps(z + i, vz);
+    }
+    deinterleaveScalar(src + numSimd, numVertices - numSimd, x + numSimd, y + numSimd, z + numSimd);
+}
+
+MYRENDER_TARGET_AVX2 void interleaveAvx2(const float* x, const float* y, const float* z, size_t numVertices, glm::vec3* dst)
+{
+    const size_t numSimd = numVertices - numVertices % 8;
+    float* data = reinterpret_cast<float*>(dst);
+    for(size_t i = 0; i < numSimd; i += 8, data += 24)
+    {
+        storeInterleavedAvx(data, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), _mm256_loadu_ps(z + i));
+    }
+    interleaveScalar(x + numSimd, y + numSimd, z + numSimd, numVertices - numSimd, dst + numSimd);
+}
+
+MYRENDER_TARGET_AVX2 uint32_t computeMaxIndexAvx2(const uint32_t* indices, size_t numIndices)
+{
+    const size_t numSimd = numIndices - numIndices % 8;
+    __m256i maxIndex = _mm256_setzero_si256();
+    for(size_t i = 0; i < numSimd; i += 8)
+    {
+        maxIndex = _mm256_max_epu32(maxIndex, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)));
+    }
+
+    __m128i v = _mm_max_epu32(_mm256_castsi256_si128(maxIndex), _mm256_extracti128_si256(maxIndex, 1));
+    v = _mm_max_epu32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_epu32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    const uint32_t result = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+    return glm::max(result, computeMaxIndexScalar(indices + numSimd, numIndices - numSimd));
+}
+
+// The packs work per 128 bit lane, the permutes restore the order of the indices
+MYRENDER_TARGET_AVX2 inline __m256i narrowToShortsAvx(const uint32_t* src)
+{
+    const __m256i packed = _mm256_packus_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 8)));
+    return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+MYRENDER_TARGET_AVX2 void narrowIndicesAvx2(const uint32_t* src, size_t numIndices, uint16_t* dst)
+{
+    const size_t numSimd = numIndices - numIndices % 16;
+    for(size_t i = 0; i < numSimd; i += 16)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), narrowToShortsAvx(src + i));
+    }
+    narrowIndicesScalar(src + numSimd, numIndices - numSimd, dst + numSimd);
+}
+
+MYRENDER_TARGET_AVX2 void narrowIndicesAvx2(const uint32_t* src, size_t numIndices, uint8_t* dst)
+{
+    const size_t numSimd = numIndices - numIndices % 32;
+    for(size_t i = 0; i < numSimd; i += 32)
+    {
+        const __m256i packed = _mm256_packus_epi16(narrowToShortsAvx(src + i), narrowToShortsAvx(src + i + 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    narrowIndicesScalar(src + numSimd, numIndices - numSimd, dst + numSimd);
+}
+
+#endif
+
+BoundingBox computeBoundingBox(const glm::vec3* vertices, size_t numVertices)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: return computeBoundingBoxAvx2(vertices, numVertices);
+        case Simd::Level::SSE: return computeBoundingBoxSse(vertices, numVertices);
+#endif
+        default: return computeBoundingBoxScalar(vertices, numVertices);
+    }
+}
+
+BoundingBox transformAndComputeBoundingBox(glm::vec3* vertices, size_t numVertices, const glm::mat4& trans)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: return transformAndComputeBoundingBoxAvx2(vertices, numVertices, trans);
+        case Simd::Level::SSE: return transformAndComputeBoundingBoxSse(vertices, numVertices, trans);
+#endif
+        default: return transformAndComputeBoundingBoxScalar(vertices, numVertices, trans);
+    }
+}
+
+BoundingBox computeBoundingBox(const float* x, const float* y, const float* z, size_t numVertices)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: return computeBoundingBoxAvx2(x, y, z, numVertices);
+        case Simd::Level::SSE: return computeBoundingBoxSse(x, y, z, numVertices);
+#endif
+        default: return computeBoundingBoxScalar(x, y, z, numVertices);
+    }
+}
+
+BoundingBox transformAndComputeBoundingBox(float* x, float* y, float* z, size_t numVertices, const glm::mat4& trans)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: return transformAndComputeBoundingBoxAvx2(x, y, z, numVertices, trans);
+        case Simd::Level::SSE: return transformAndComputeBoundingBoxSse(x, y, z, numVertices, trans);
+#endif
+        default: return transformAndComputeBoundingBoxScalar(x, y, z, numVertices, trans);
+    }
+}
+
+void deinterleave(const glm::vec3* src, size_t numVertices, float* x, float* y, float* z)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: deinterleaveAvx2(src, numVertices, x, y, z); break;
+        case Simd::Level::SSE: deinterleaveSse(src, numVertices, x, y, z); break;
+#endif
+        default: deinterleaveScalar(src, numVertices, x, y, z); break;
+    }
+}
+
+void interleave(const float* x, const float* y, const float* z, size_t numVertices, glm::vec3* dst)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: interleaveAvx2(x, y, z, numVertices, dst); break;
+        case Simd::Level::SSE: interleaveSse(x, y, z, numVertices, dst); break;
+#endif
+        default: interleaveScalar(x, y, z, numVertices, dst); break;
+    }
+}
+
+uint32_t computeMaxIndex(const uint32_t* indices, size_t numIndices)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: return computeMaxIndexAvx2(indices, numIndices);
+        case Simd::Level::SSE: return computeMaxIndexSse(indices, numIndices);
+#endif
+        default: return computeMaxIndexScalar(indices, numIndices);
+    }
+}
+
+void narrowIndices(const uint32_t* src, size_t numIndices, uint16_t* dst)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: narrowIndicesAvx2(src, numIndices, dst); break;
+        case Simd::Level::SSE: narrowIndicesSse(src, numIndices, dst); break;
+#endif
+        default: narrowIndicesScalar(src, numIndices, dst); break;
+    }
+}
+
+void narrowIndices(const uint32_t* src, size_t numIndices, uint8_t* dst)
+{
+    switch(Simd::getLevel())
+    {
+#ifdef MYRENDER_SIMD_X86
+        case Simd::Level::AVX2: narrowIndicesAvx2(src, numIndices, dst); break;
+        case Simd::Level::SSE: narrowIndicesSse(src, numIndices, dst); break;
+#endif
+        default: narrowIndicesScalar(src, numIndices, dst); break;
+    }
+}
+
+
+}
+
+}
\ No newline at end of file
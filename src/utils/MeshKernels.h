@@ -0,0 +1,36 @@
+#ifndef MESH_KERNELS_H
+#define MESH_KERNELS_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    VertexAdjacency computeVertexAdjacency(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t numThreads);
+
+    // Single threaded kernels over a range of vertices. They use the instruction set given by Simd::getLevel()
+    BoundingBox computeBoundingBox(const glm::vec3* vertices, size_t numVertices);
+    // Applies the affine part of trans to the vertices and returns the bounding box of the result
+    BoundingBox transformAndComputeBoundingBox(glm::vec3* vertices, size_t numVertices, const glm::mat4& trans);
+
+    // Same kernels over vertices stored as one array per component
+    BoundingBox computeBoundingBox(const float* x, const float* y, const float* z, size_t numVertices);
+    BoundingBox transformAndComputeBoundingBox(float* x, float* y, float* z, size_t numVertices, const glm::mat4& trans);
+
+    // Conversion between interleaved vec3 and one array per component
+    void deinterleave(const glm::vec3* src, size_t numVertices, float* x, float* y, float* z);
+    void interleave(const float* x, const float* y, const float* z, size_t numVertices, glm::vec3* dst);
+
+    uint32_t computeMaxIndex(const uint32_t* indices, size_t numIndices);
+    // Converts to smaller index types, the indices must fit in the destination type
+    void narrowIndices(const uint32_t* src, size_t numIndices, uint16_t* dst);
+    void narrowIndices(const uint32_t* src, size_t numIndices, uint8_t* dst);
+}
+
+}
+
+#endif
@@ -0,0 +1,963 @@
+#include "MyRender/utils/MeshLoader.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "MyRender/utils/MappedFile.h"
+#include "MyRender/utils/Parallel.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    // Files are split in chunks of at least this size to be parsed in parallel
+    constexpr size_t OBJ_MIN_CHUNK_SIZE = 1 << 20;
+
+    // Face references are resolved after merging the chunks. Positive OBJ indices are stored as absolute
+    // 0-based indices, negative ones as an index relative to the first element of the chunk with this bit set
+    constexpr uint32_t OBJ_RELATIVE_REFERENCE = 1u << 31;
+    constexpr int64_t OBJ_RELATIVE_BIAS = 1 << 30;
+
+    constexpr double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+    inline bool isDigit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+    inline const char* skipSpaces(const char* p, const char* end)
+    {
+        while(p < end && isSpace(*p)) p++;
+        return p;
+    }
+
+    // Decimal float parser: the first 19 significant digits are accumulated as an integer and scaled once by
+    // a power of ten. Much faster than strtof and within one ulp for the values written by the usual exporters.
+    // Returns nullptr when there is no number
+    const char* parseFloat(const char* p, const char* end, float& value)
+    {
+        p = skipSpaces(p, end);
+        bool negative = false;
+        if(p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+        uint64_t mantissa = 0;
+        int32_t exponent = 0;
+        uint32_t numDigits = 0;
+        bool anyDigit = false;
+        for(; p < end && isDigit(*p); p++)
+        {
+            anyDigit = true;
+            if(numDigits < 19)
+            {
+                mantissa = 10 * mantissa + static_cast<uint64_t>(*p - '0');
+                numDigits += mantissa > 0;
+            }
+            else exponent++;
+        }
+        if(p < end && *p == '.')
+        {
+            for(p++; p < end && isDigit(*p); p++)
+            {
+                anyDigit = true;
+                if(numDigits < 19)
+                {
+                    mantissa = 10 * mantissa + static_cast<uint64_t>(*p - '0');
+                    numDigits += mantissa > 0;
+                    exponent--;
+                }
+            }
+        }
+        if(!anyDigit) return nullptr;
+
+        if(p < end && (*p == 'e' || *p == 'E'))
+        {
+            p++;
+            bool negativeExponent = false;
+            if(p < end && (*p == '-' || *p == '+')) negativeExponent = *p++ == '-';
+            int32_t e = 0;
+            for(; p < end && isDigit(*p); p++) e = std::min(10 * e + (*p - '0'), 9999);
+            exponent += negativeExponent ? -e : e;
+        }
+
+        double v = static_cast<double>(mantissa);
+        for(; exponent > 22; exponent -= 22) v *= 1e22;
+        for(; exponent < -22; exponent += 22) v /= 1e22;
+        v = exponent >= 0 ? v * POWERS_OF_TEN[exponent] : v / POWERS_OF_TEN[-exponent];
+        value = static_cast<float>(negative ? -v : v);
+        return p;
+    }
+
+    // OBJ index, 1-based or negative from the last element. Returns nullptr when it is missing or 0
+    const char* parseIndex(const char* p, const char* end, int64_t& value)
+    {
+        bool negative = false;
+        if(p < end && *p == '-')
+        {
+            negative = true;
+            p++;
+        }
+        if(p == end || !isDigit(*p)) return nullptr;
+        value = 0;
+        for(; p < end && isDigit(*p); p++) value = std::min<int64_t>(10 * value + (*p - '0'), INT64_C(1) << 40);
+        if(value == 0) return nullptr;
+        if(negative) value = -value;
+        return p;
+    }
+
+    inline uint32_t encodeObjReference(int64_t index, size_t numLocalElements)
+    {
+        if(index > 0) return static_cast<uint32_t>(std::min<int64_t>(index - 1, OBJ_RELATIVE_REFERENCE - 1));
+        return OBJ_RELATIVE_REFERENCE | static_cast<uint32_t>(static_cast<int64_t>(numLocalElements) + index + OBJ_RELATIVE_BIAS);
+    }
+
+    // Returns the 0-based global index, or -1 when the reference goes before the first element
+    inline int64_t decodeObjReference(uint32_t reference, size_t chunkBase)
+    {
+        if((reference & OBJ_RELATIVE_REFERENCE) == 0) return reference;
+        const int64_t index = static_cast<int64_t>(chunkBase) + static_cast<int64_t>(reference & ~OBJ_RELATIVE_REFERENCE) - OBJ_RELATIVE_BIAS;
+        return index >= 0 ? index : -1;
+    }
+
+    struct ObjChunk
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<uint32_t> positionReferences; // One per triangle corner
+        std::vector<uint32_t> normalReferences;
+        bool allCornersHaveNormals = true;
+        size_t firstInvalidLine = 0; // Offset in the file, 0 when everything could be parsed
+        bool valid = true;
+    };
+
+    void parseObjChunk(const char* begin, const char* end, const char* fileBegin, bool loadNormals, ObjChunk& chunk)
+    {
+        auto fail = [&](const char* line)
+        {
+            if(chunk.valid) chunk.firstInvalidLine = static_cast<size_t>(line - fileBegin);
+            chunk.valid = false;
+        };
+
+        const char* p = begin;
+        while(p < end)
+        {
+            const char* lineBegin = skipSpaces(p, end);
+            const char* lineEnd = reinterpret_cast<const char*>(std::memchr(lineBegin, '\n', static_cast<size_t>(end - lineBegin)));
+            if(lineEnd == nullptr) lineEnd = end;
+            p = lineEnd + 1;
+            if(lineEnd - lineBegin < 2) continue;
+
+            if(lineBegin[0] == 'v' && isSpace(lineBegin[1]))
+            {
+                glm::vec3 position;
+                const char* q = lineBegin + 2;
+                if((q = parseFloat(q, lineEnd, position.x)) && (q = parseFloat(q, lineEnd, position.y)) &&
+                   (q = parseFloat(q, lineEnd, position.z)))
+                {
+                    chunk.positions.push_back(position);
+                }
+                else fail(lineBegin);
+            }
+            else if(lineBegin[0] == 'v' && lineBegin[1] == 'n')
+            {
+                if(!loadNormals || lineEnd - lineBegin < 3 || !isSpace(lineBegin[2])) continue;
+                glm::vec3 normal;
+                const char* q = lineBegin + 3;
+                if((q = parseFloat(q, lineEnd, normal.x)) && (q = parseFloat(q, lineEnd, normal.y)) &&
+                   (q = parseFloat(q, lineEnd, normal.z)))
+                {
+                    chunk.normals.push_back(normal);
+                }
+                else fail(lineBegin);
+            }
+            else if(lineBegin[0] == 'f' && isSpace(lineBegin[1]))
+            {
+                // Corners as v, v/vt, v//vn or v/vt/vn, triangulated as a fan around the first one
+                uint32_t numCorners = 0;
+                uint32_t firstPosition = 0, firstNormal = 0, lastPosition = 0, lastNormal = 0;
+                const char* q = lineBegin + 2;
+                while(true)
+                {
+                    q = skipSpaces(q, lineEnd);
+                    if(q == lineEnd || *q == '#') break;
+
+                    int64_t positionIndex, normalIndex = 0, texCoordIndex;
+                    if(!(q = parseIndex(q, lineEnd, positionIndex))) break;
+                    if(q < lineEnd && *q == '/')
+                    {
+                        q++;
+                        if(q < lineEnd && *q != '/' && !(q = parseIndex(q, lineEnd, texCoordIndex))) break;
+                        if(q < lineEnd && *q == '/' && !(q = parseIndex(q + 1, lineEnd, normalIndex))) break;
+                    }
+                    if(q < lineEnd && !isSpace(*q))
+                    {
+                        q = nullptr;
+                        break;
+                    }
+
+                    const uint32_t position = encodeObjReference(positionIndex, chunk.positions.size());
+                    const uint32_t normal = normalIndex != 0 ? encodeObjReference(normalIndex, chunk.normals.size()) : 0;
+                    chunk.allCornersHaveNormals &= normalIndex != 0;
+
+                    if(numCorners == 0)
+                    {
+                        firstPosition = position;
+                        firstNormal = normal;
+                    }
+                    else if(numCorners >= 2)
+                    {
+                        chunk.positionReferences.insert(chunk.positionReferences.end(), {firstPosition, lastPosition, position});
+                        chunk.normalReferences.insert(chunk.normalReferences.end(), {firstNormal, lastNormal, normal});
+                    }
+                    lastPosition = position;
+                    lastNormal = normal;
+                    numCorners++;
+                }
+                if(q == nullptr || numCorners < 3) fail(lineBegin);
+            }
+        }
+    }
+
+    // Open addressing map from a position and normal pair to its vertex, grown when half full
+    class VertexPairMap
+    {
+    public:
+        explicit VertexPairMap(size_t expectedSize) { resize(std::max<size_t>(64, 2 * expectedSize)); }
+
+        // Returns the vertex of the pair, inserting it with newVertex if it is not there
+        uint32_t insert(uint64_t key, uint32_t newVertex)
+        {
+            if(2 * (mSize + 1) > mKeys.size()) resize(2 * mKeys.size());
+            size_t slot = hash(key) & (mKeys.size() - 1);
+            while(mKeys[slot] != EMPTY)
+            {
+                if(mKeys[slot] == key) return mValues[slot];
+                slot = (slot + 1) & (mKeys.size() - 1);
+            }
+            mKeys[slot] = key;
+            mValues[slot] = newVertex;
+            mSize++;
+            return newVertex;
+        }
+
+    private:
+        static constexpr uint64_t EMPTY = ~UINT64_C(0);
+        std::vector<uint64_t> mKeys;
+        std::vector<uint32_t> mValues;
+        size_t mSize = 0;
+
+        static size_t hash(uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= UINT64_C(0xff51afd7ed558ccd);
+            key ^= key >> 33;
+            return static_cast<size_t>(key);
+        }
+
+        void resize(size_t minCapacity)
+        {
+            size_t capacity = 64;
+            while(capacity < minCapacity) capacity *= 2;
+            std::vector<uint64_t> oldKeys(capacity, EMPTY);
+            std::vector<uint32_t> oldValues(capacity);
+            oldKeys.swap(mKeys);
+            oldValues.swap(mValues);
+            mSize = 0;
+            for(size_t i = 0; i < oldKeys.size(); i++)
+            {
+                if(oldKeys[i] != EMPTY) insert(oldKeys[i], oldValues[i]);
+            }
+        }
+    };
+}
+
+std::shared_ptr<Mesh> MeshLoader::loadObj(const std::string& path, bool loadNormals, uint32_t numThreads)
+{
+    using namespace internal;
+    MappedFile file;
+    if(!file.open(path))
+    {
+        std::cout << "Error: the file " << path << " could not be opened" << std::endl;
+        return nullptr;
+    }
+
+    // Chunks start after a line break, so every line is parsed by a single chunk
+    const char* fileBegin = reinterpret_cast<const char*>(file.getData());
+    const char* fileEnd = fileBegin + file.getSize();
+    const size_t numChunks = std::max<size_t>(1, std::min<size_t>(Parallel::getNumThreads(numThreads), file.getSize() / OBJ_MIN_CHUNK_SIZE));
+    std::vector<const char*> chunkBegins(numChunks + 1, fileEnd);
+    chunkBegins[0] = fileBegin;
+    for(size_t c = 1; c < numChunks; c++)
+    {
+        const char* p = std::max(chunkBegins[c - 1], fileBegin + c * (file.getSize() / numChunks));
+        const char* lineEnd = reinterpret_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(fileEnd - p)));
+        chunkBegins[c] = lineEnd != nullptr ? lineEnd + 1 : fileEnd;
+    }
+
+    std::vector<ObjChunk> chunks(numChunks);
+    Parallel::forRange(0, numChunks, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t c = begin; c < end; c++) parseObjChunk(chunkBegins[c], chunkBegins[c + 1], fileBegin, loadNormals, chunks[c]);
+    }, numThreads, 1);
+
+    // Offsets of each chunk in the merged arrays
+    std::vector<size_t> positionBases(numChunks + 1, 0), normalBases(numChunks + 1, 0), cornerBases(numChunks + 1, 0);
+    bool useNormals = loadNormals;
+    for(size_t c = 0; c < numChunks; c++)
+    {
+        if(!chunks[c].valid)
+        {
+            const size_t lineNumber = 1 + static_cast<size_t>(std::count(fileBegin, fileBegin + chunks[c].firstInvalidLine, '\n'));
+            std::cout << "Error: the file " << path << " could not be parsed at line " << lineNumber << std::endl;
+            return nullptr;
+        }
+        positionBases[c + 1] = positionBases[c] + chunks[c].positions.size();
+        normalBases[c + 1] = normalBases[c] + chunks[c].normals.size();
+        cornerBases[c + 1] = cornerBases[c] + chunks[c].positionReferences.size();
+        useNormals &= chunks[c].allCornersHaveNormals;
+    }
+    const size_t numPositions = positionBases[numChunks];
+    const size_t numNormals = normalBases[numChunks];
+    const size_t numCorners = cornerBases[numChunks];
+    useNormals &= numNormals > 0;
+    if(numPositions > OBJ_RELATIVE_REFERENCE || numNormals > OBJ_RELATIVE_REFERENCE)
+    {
+        std::cout << "Error: the file " << path << " has too many vertices" << std::endl;
+        return nullptr;
+    }
+
+    std::vector<glm::vec3> positions(numPositions);
+    std::vector<glm::vec3> normals(useNormals ? numNormals : 0);
+    std::vector<uint32_t> positionIndices(numCorners);
+    std::vector<uint32_t> normalIndices(useNormals ? numCorners : 0);
+    std::atomic<bool> validIndices(true);
+    Parallel::forRange(0, numChunks, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t c = begin; c < end; c++)
+        {
+            ObjChunk& chunk = chunks[c];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + positionBases[c]);
+            for(size_t i = 0; i < chunk.positionReferences.size(); i++)
+            {
+                const int64_t index = decodeObjReference(chunk.positionReferences[i], positionBases[c]);
+                if(index < 0 || index >= static_cast<int64_t>(numPositions)) validIndices = false;
+                positionIndices[cornerBases[c] + i] = static_cast<uint32_t>(index);
+            }
+
+            if(useNormals)
+            {
+                std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + normalBases[c]);
+                for(size_t i = 0; i < chunk.normalReferences.size(); i++)
+                {
+                    const int64_t index = decodeObjReference(chunk.normalReferences[i], normalBases[c]);
+                    if(index < 0 || index >= static_cast<int64_t>(numNormals)) validIndices = false;
+                    normalIndices[cornerBases[c] + i] = static_cast<uint32_t>(index);
+                }
+            }
+            chunk = ObjChunk();
+        }
+    }, numThreads, 1);
+
+    if(!validIndices)
+    {
+        std::cout << "Error: the file " << path << " has faces referencing missing vertices" << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    if(!useNormals)
+    {
+        mesh->getVertices() = std::move(positions);
+        mesh->getIndices() = std::move(positionIndices);
+        mesh->computeBoundingBox(numThreads);
+        return mesh;
+    }
+
+    // Exporters usually write one normal per position with the same index, then there is nothing to merge
+    bool sameIndices = numPositions == numNormals;
+    if(sameIndices)
+    {
+        std::atomic<bool> allEqual(true);
+        Parallel::forRange(0, numCorners, [&](size_t begin, size_t end, uint32_t)
+        {
+            if(!std::equal(positionIndices.begin() + begin, positionIndices.begin() + end, normalIndices.begin() + begin)) allEqual = false;
+        }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+        sameIndices = allEqual;
+    }
+
+    if(sameIndices)
+    {
+        mesh->getVertices() = std::move(positions);
+        mesh->getNormals() = std::move(normals);
+        mesh->getIndices() = std::move(positionIndices);
+    }
+    else
+    {
+        // One vertex per distinct pair, in order of first use
+        std::vector<glm::vec3>& vertices = mesh->getVertices();
+        std::vector<glm::vec3>& vertexNormals = mesh->getNormals();
+        std::vector<uint32_t>& indices = mesh->getIndices();
+        vertices.reserve(numPositions);
+        vertexNormals.reserve(numPositions);
+        indices.resize(numCorners);
+
+        VertexPairMap map(numPositions);
+        for(size_t i = 0; i < numCorners; i++)
+        {
+            const uint64_t key = (static_cast<uint64_t>(positionIndices[i]) << 32) | normalIndices[i];
+            const uint32_t vertex = map.insert(key, static_cast<uint32_t>(vertices.size()));
+            if(vertex == vertices.size())
+            {
+                vertices.push_back(positions[positionIndices[i]]);
+                vertexNormals.push_back(normals[normalIndices[i]]);
+            }
+            indices[i] = vertex;
+        }
+    }
+
+    mesh->computeBoundingBox(numThreads);
+    return mesh;
+}
+
+namespace internal
+{
+    // Elements decoded between two progress reports
+    constexpr size_t LOADER_BLOCK_SIZE = 1 << 20;
+
+    // Runs func(begin, end, chunkId) over [0, count) in parallel one block at a time, and reports
+    // (done + decoded) / total after each block. Returns false when the load is cancelled
+    template<typename F>
+    bool forBlocks(size_t count, size_t done, size_t total, const MeshLoader::ProgressCallback& progress, uint32_t numThreads, F&& func)
+    {
+        for(size_t begin = 0; begin < count; begin += LOADER_BLOCK_SIZE)
+        {
+            const size_t end = std::min(count, begin + LOADER_BLOCK_SIZE);
+            Parallel::forRange(begin, end, func, numThreads);
+            if(progress && !progress(static_cast<float>(done + end) / static_cast<float>(std::max<size_t>(1, total)))) return false;
+        }
+        return true;
+    }
+
+    enum class PlyType { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64, INVALID };
+
+    struct PlyProperty
+    {
+        std::string name;
+        PlyType type;
+        PlyType countType; // INVALID when the property is not a list
+    };
+
+    struct PlyElement
+    {
+        std::string name;
+        size_t count;
+        std::vector<PlyProperty> properties;
+    };
+
+    PlyType getPlyType(const std::string& name)
+    {
+        if(name == "char" || name == "int8") return PlyType::INT8;
+        if(name == "uchar" || name == "uint8") return PlyType::UINT8;
+        if(name == "short" || name == "int16") return PlyType::INT16;
+        if(name == "ushort" || name == "uint16") return PlyType::UINT16;
+        if(name == "int" || name == "int32") return PlyType::INT32;
+        if(name == "uint" || name == "uint32") return PlyType::UINT32;
+        if(name == "float" || name == "float32") return PlyType::FLOAT32;
+        if(name == "double" || name == "float64") return PlyType::FLOAT64;
+        return PlyType::INVALID;
+    }
+
+    size_t getPlyTypeSize(PlyType type)
+    {
+        switch(type)
+        {
+            case PlyType::INT8: case PlyType::UINT8: return 1;
+            case PlyType::INT16: case PlyType::UINT16: return 2;
+            case PlyType::INT32: case PlyType::UINT32: case PlyType::FLOAT32: return 4;
+            case PlyType::FLOAT64: return 8;
+            default: return 0;
+        }
+    }
+
+    template<typename T>
+    inline T loadUnaligned(const uint8_t* data)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    inline double readPlyValue(const uint8_t* data, PlyType type)
+    {
+        switch(type)
+        {
+            case PlyType::INT8: return loadUnaligned<int8_t>(data);
+            case PlyType::UINT8: return loadUnaligned<uint8_t>(data);
+            case PlyType::INT16: return loadUnaligned<int16_t>(data);
+            case PlyType::UINT16: return loadUnaligned<uint16_t>(data);
+            case PlyType::INT32: return loadUnaligned<int32_t>(data);
+            case PlyType::UINT32: return loadUnaligned<uint32_t>(data);
+            case PlyType::FLOAT32: return loadUnaligned<float>(data);
+            case PlyType::FLOAT64: return loadUnaligned<double>(data);
+            default: return 0.0;
+        }
+    }
+
+    // Indices are read as int64 so the negative ones can be rejected
+    inline int64_t readPlyIndex(const uint8_t* data, PlyType type)
+    {
+        switch(type)
+        {
+            case PlyType::INT8: return loadUnaligned<int8_t>(data);
+            case PlyType::UINT8: return loadUnaligned<uint8_t>(data);
+            case PlyType::INT16: return loadUnaligned<int16_t>(data);
+            case PlyType::UINT16: return loadUnaligned<uint16_t>(data);
+            case PlyType::INT32: return loadUnaligned<int32_t>(data);
+            case PlyType::UINT32: return loadUnaligned<uint32_t>(data);
+            default: return static_cast<int64_t>(readPlyValue(data, type));
+        }
+    }
+
+    // Returns the size of the element without lists, or 0 when it has lists
+    size_t getPlyElementStride(const PlyElement& element)
+    {
+        size_t stride = 0;
+        for(const PlyProperty& property : element.properties)
+        {
+            if(property.countType != PlyType::INVALID) return 0;
+            stride += getPlyTypeSize(property.type);
+        }
+        return stride;
+    }
+
+    // Size of one element with lists, or 0 if it does not fit before end
+    size_t getPlyElementSize(const PlyElement& element, const uint8_t* data, const uint8_t* end)
+    {
+        const uint8_t* p = data;
+        for(const PlyProperty& property : element.properties)
+        {
+            if(property.countType != PlyType::INVALID)
+            {
+                if(p + getPlyTypeSize(property.countType) > end) return 0;
+                const int64_t count = readPlyIndex(p, property.countType);
+                if(count < 0) return 0;
+                p += getPlyTypeSize(property.countType) + static_cast<size_t>(count) * getPlyTypeSize(property.type);
+            }
+            else p += getPlyTypeSize(property.type);
+            if(p > end) return 0;
+        }
+        return static_cast<size_t>(p - data);
+    }
+
+    // Parses the text header, returning the offset of the binary data or 0 on error
+    size_t parsePlyHeader(const uint8_t* data, size_t size, std::vector<PlyElement>& elements, std::string& error)
+    {
+        const char* begin = reinterpret_cast<const char*>(data);
+        const char* end = begin + size;
+        const char* p = begin;
+        bool binaryLittleEndian = false;
+        bool firstLine = true;
+        while(p < end)
+        {
+            const char* lineEnd = reinterpret_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if(lineEnd == nullptr) break;
+            std::vector<std::string> tokens;
+            for(const char* q = p; q < lineEnd;)
+            {
+                q = skipSpaces(q, lineEnd);
+                const char* tokenEnd = q;
+                while(tokenEnd < lineEnd && !isSpace(*tokenEnd)) tokenEnd++;
+                if(tokenEnd > q) tokens.emplace_back(q, tokenEnd);
+                q = tokenEnd;
+            }
+            p = lineEnd + 1;
+
+            if(firstLine)
+            {
+                if(tokens.size() != 1 || tokens[0] != "ply") break;
+                firstLine = false;
+            }
+            else if(tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info") continue;
+            else if(tokens[0] == "format")
+            {
+                if(tokens.size() < 2 || tokens[1] != "binary_little_endian")
+                {
+                    error = "only binary little endian files are supported";
+                    return 0;
+                }
+                binaryLittleEndian = true;
+            }
+            else if(tokens[0] == "element" && tokens.size() == 3)
+            {
+                // The indices are 32 bits, so larger counts cannot be loaded
+                const unsigned long long count = std::strtoull(tokens[2].c_str(), nullptr, 10);
+                if(count > UINT32_MAX)
+                {
+                    error = "too many elements " + tokens[1];
+                    return 0;
+                }
+                elements.push_back({tokens[1], static_cast<size_t>(count), {}});
+            }
+            else if(tokens[0] == "property" && !elements.empty())
+            {
+                PlyProperty property;
+                if(tokens.size() == 5 && tokens[1] == "list") property = {tokens[4], getPlyType(tokens[3]), getPlyType(tokens[2])};
+                else if(tokens.size() == 3) property = {tokens[2], getPlyType(tokens[1]), PlyType::INVALID};
+                else break;
+                if(property.type == PlyType::INVALID || (tokens[1] == "list" && property.countType == PlyType::INVALID)) break;
+                elements.back().properties.push_back(property);
+            }
+            else if(tokens[0] == "end_header")
+            {
+                if(!binaryLittleEndian) break;
+                return static_cast<size_t>(p - begin);
+            }
+            else break;
+        }
+        if(error.empty()) error = "invalid header";
+        return 0;
+    }
+
+    // Offset of the property in the element, or -1 if it is missing
+    int64_t findPlyProperty(const PlyElement& element, const std::string& name, PlyType& type)
+    {
+        size_t offset = 0;
+        for(const PlyProperty& property : element.properties)
+        {
+            if(property.name == name)
+            {
+                type = property.type;
+                return static_cast<int64_t>(offset);
+            }
+            offset += getPlyTypeSize(property.type);
+        }
+        return -1;
+    }
+
+    // Decodes the vertices, returning false on error or cancellation
+    bool decodePlyVertices(const PlyElement& element, const uint8_t* data, size_t total, Mesh& mesh,
+                           const MeshLoader::ProgressCallback& progress, uint32_t numThreads, bool& cancelled)
+    {
+        const size_t stride = getPlyElementStride(element);
+        PlyType types[6] = {PlyType::INVALID, PlyType::INVALID, PlyType::INVALID, PlyType::INVALID, PlyType::INVALID, PlyType::INVALID};
+        int64_t offsets[6];
+        const char* names[6] = {"x", "y", "z", "nx", "ny", "nz"};
+        for(uint32_t i = 0; i < 6; i++) offsets[i] = findPlyProperty(element, names[i], types[i]);
+        if(offsets[0] < 0 || offsets[1] < 0 || offsets[2] < 0) return false;
+        const bool hasNormals = offsets[3] >= 0 && offsets[4] >= 0 && offsets[5] >= 0;
+
+        // Most files store x, y, z and nx, ny, nz as consecutive floats
+        auto isPackedVec3 = [&](uint32_t first)
+        {
+            return types[first] == PlyType::FLOAT32 && types[first + 1] == PlyType::FLOAT32 && types[first + 2] == PlyType::FLOAT32 &&
+                   offsets[first + 1] == offsets[first] + 4 && offsets[first + 2] == offsets[first] + 8;
+        };
+        const bool packedPositions = isPackedVec3(0);
+        const bool packedNormals = hasNormals && isPackedVec3(3);
+
+        std::vector<glm::vec3>& vertices = mesh.getVertices();
+        std::vector<glm::vec3>& normals = mesh.getNormals();
+        vertices.resize(element.count);
+        if(hasNormals) normals.resize(element.count);
+
+        cancelled = !forBlocks(element.count, 0, total, progress, numThreads, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; v++)
+            {
+                const uint8_t* vertex = data + v * stride;
+                if(packedPositions) std::memcpy(&vertices[v], vertex + offsets[0], sizeof(glm::vec3));
+                else
+                {
+                    for(uint32_t c = 0; c < 3; c++) vertices[v][c] = static_cast<float>(readPlyValue(vertex + offsets[c], types[c]));
+                }
+
+                if(packedNormals) std::memcpy(&normals[v], vertex + offsets[3], sizeof(glm::vec3));
+                else if(hasNormals)
+                {
+                    for(uint32_t c = 0; c < 3; c++) normals[v][c] = static_cast<float>(readPlyValue(vertex + offsets[3 + c], types[3 + c]));
+                }
+            }
+        });
+        return !cancelled;
+    }
+
+    // Decodes the faces, returning the end of the element or nullptr on error or cancellation
+    const uint8_t* decodePlyFaces(const PlyElement& element, const uint8_t* data, const uint8_t* end, size_t numVertices,
+                                  size_t total, Mesh& mesh, const MeshLoader::ProgressCallback& progress, uint32_t numThreads,
+                                  bool& cancelled)
+    {
+        // Layout of a triangle, assuming the other properties are not lists
+        size_t listProperty = element.properties.size();
+        size_t offsetBefore = 0, sizeAfter = 0;
+        bool fixedOthers = true;
+        for(size_t i = 0; i < element.properties.size(); i++)
+        {
+            const PlyProperty& property = element.properties[i];
+            if(property.countType != PlyType::INVALID && (property.name == "vertex_indices" || property.name == "vertex_index") &&
+               listProperty == element.properties.size())
+            {
+                listProperty = i;
+                continue;
+            }
+            if(property.countType != PlyType::INVALID) fixedOthers = false;
+            (listProperty == element.properties.size() ? offsetBefore : sizeAfter) += getPlyTypeSize(property.type);
+        }
+        if(listProperty == element.properties.size()) return nullptr;
+        const PlyType countType = element.properties[listProperty].countType;
+        const PlyType indexType = element.properties[listProperty].type;
+        const size_t countSize = getPlyTypeSize(countType);
+        const size_t indexSize = getPlyTypeSize(indexType);
+
+        std::vector<uint32_t>& indices = mesh.getIndices();
+        std::atomic<bool> valid(true);
+
+        // Fast path when every face is a triangle, the stride is fixed and the faces are decoded in parallel.
+        // What it reports is kept, so the progress does not go back if it falls back to the polygons
+        float reported = static_cast<float>(numVertices) / static_cast<float>(std::max<size_t>(1, total));
+        const size_t triangleStride = offsetBefore + countSize + 3 * indexSize + sizeAfter;
+        if(fixedOthers && element.count <= static_cast<size_t>(end - data) / triangleStride)
+        {
+            indices.resize(3 * element.count);
+            std::atomic<bool> allTriangles(true);
+            MeshLoader::ProgressCallback fastProgress = nullptr;
+            if(progress)
+            {
+                fastProgress = [&](float value)
+                {
+                    if(!allTriangles) return true;
+                    reported = value;
+                    return progress(value);
+                };
+            }
+            if(!forBlocks(element.count, numVertices, total, fastProgress, numThreads, [&](size_t begin, size_t blockEnd, uint32_t)
+            {
+                if(!allTriangles) return;
+                for(size_t f = begin; f < blockEnd; f++)
+                {
+                    const uint8_t* face = data + f * triangleStride + offsetBefore;
+                    if(readPlyIndex(face, countType) != 3)
+                    {
+                        allTriangles = false;
+                        return;
+                    }
+                    for(uint32_t k = 0; k < 3; k++)
+                    {
+                        const int64_t index = readPlyIndex(face + countSize + k * indexSize, indexType);
+                        if(index < 0 || index >= static_cast<int64_t>(numVertices)) valid = false;
+                        indices[3 * f + k] = static_cast<uint32_t>(index);
+                    }
+                }
+            }))
+            {
+                cancelled = true;
+                return nullptr;
+            }
+            if(allTriangles) return valid ? data + element.count * triangleStride : nullptr;
+        }
+
+        // Polygons, walked one face after the other
+        indices.clear();
+        const uint8_t* p = data;
+        for(size_t f = 0; f < element.count; f++)
+        {
+            const uint8_t* face = p;
+            const size_t size = getPlyElementSize(element, face, end);
+            if(size == 0) return nullptr;
+            p += size;
+
+            for(size_t i = 0; i < listProperty; i++) face += getPlyTypeSize(element.properties[i].type);
+            const int64_t count = readPlyIndex(face, countType);
+            face += countSize;
+            for(int64_t k = 0; k < count; k++)
+            {
+                const int64_t index = readPlyIndex(face + k * indexSize, indexType);
+                if(index < 0 || index >= static_cast<int64_t>(numVertices)) return nullptr;
+                if(k >= 2)
+                {
+                    indices.insert(indices.end(), {static_cast<uint32_t>(readPlyIndex(face, indexType)),
+                                                   static_cast<uint32_t>(readPlyIndex(face + (k - 1) * indexSize, indexType)),
+                                                   static_cast<uint32_t>(index)});
+                }
+            }
+
+            const float done = static_cast<float>(f + 1) / static_cast<float>(element.count);
+            if((f + 1) % LOADER_BLOCK_SIZE == 0 && progress && !progress(reported + (1.0f - reported) * done))
+            {
+                cancelled = true;
+                return nullptr;
+            }
+        }
+        if(progress && !progress(1.0f))
+        {
+            cancelled = true;
+            return nullptr;
+        }
+        return p;
+    }
+}
+
+std::shared_ptr<Mesh> MeshLoader::loadPly(const std::string& path, const ProgressCallback& progress, uint32_t numThreads)
+{
+    using namespace internal;
+    MappedFile file;
+    if(!file.open(path))
+    {
+        std::cout << "Error: the file " << path << " could not be opened" << std::endl;
+        return nullptr;
+    }
+
+    std::vector<PlyElement> elements;
+    std::string error;
+    const size_t headerSize = parsePlyHeader(file.getData(), file.getSize(), elements, error);
+    if(headerSize == 0)
+    {
+        std::cout << "Error: the file " << path << " could not be loaded, " << error << std::endl;
+        return nullptr;
+    }
+
+    size_t numVertices = 0, numFaces = 0;
+    for(const PlyElement& element : elements)
+    {
+        if(element.name == "vertex") numVertices = element.count;
+        else if(element.name == "face") numFaces = element.count;
+    }
+    const size_t total = numVertices + numFaces;
+
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    const uint8_t* p = file.getData() + headerSize;
+    const uint8_t* end = file.getData() + file.getSize();
+    bool cancelled = false;
+    for(const PlyElement& element : elements)
+    {
+        const size_t stride = getPlyElementStride(element);
+        if(element.name == "vertex")
+        {
+            if(stride == 0 || element.count > static_cast<size_t>(end - p) / stride)
+            {
+                error = "invalid vertices";
+                break;
+            }
+            if(!decodePlyVertices(element, p, total, *mesh, progress, numThreads, cancelled))
+            {
+                if(!cancelled) error = "missing vertex positions";
+                break;
+            }
+            p += element.count * stride;
+        }
+        else if(element.name == "face")
+        {
+            p = decodePlyFaces(element, p, end, numVertices, total, *mesh, progress, numThreads, cancelled);
+            if(p == nullptr)
+            {
+                if(!cancelled) error = "invalid faces";
+                break;
+            }
+        }
+        else if(stride > 0)
+        {
+            if(element.count > static_cast<size_t>(end - p) / stride)
+            {
+                error = "truncated element " + element.name;
+                break;
+            }
+            p += element.count * stride;
+        }
+        else
+        {
+            for(size_t i = 0; i < element.count && p != nullptr; i++)
+            {
+                const size_t size = getPlyElementSize(element, p, end);
+                p = size > 0 ? p + size : nullptr;
+            }
+            if(p == nullptr)
+            {
+                error = "truncated element " + element.name;
+                break;
+            }
+        }
+    }
+
+    if(cancelled) return nullptr;
+    if(!error.empty())
+    {
+        std::cout << "Error: the file " << path << " could not be loaded, " << error << std::endl;
+        return nullptr;
+    }
+
+    mesh->computeBoundingBox(numThreads);
+    return mesh;
+}
+
+std::shared_ptr<Mesh> MeshLoader::loadStl(const std::string& path, bool weld, float weldEpsilon,
+                                          const ProgressCallback& progress, uint32_t numThreads)
+{
+    using namespace internal;
+    constexpr size_t HEADER_SIZE = 84;
+    constexpr size_t TRIANGLE_SIZE = 50; // Normal, three vertices and a 16 bit attribute
+
+    MappedFile file;
+    if(!file.open(path))
+    {
+        std::cout << "Error: the file " << path << " could not be opened" << std::endl;
+        return nullptr;
+    }
+
+    const uint8_t* data = file.getData();
+    const size_t numTriangles = file.getSize() >= HEADER_SIZE ? loadUnaligned<uint32_t>(data + 80) : 0;
+    if(file.getSize() < HEADER_SIZE || file.getSize() < HEADER_SIZE + numTriangles * TRIANGLE_SIZE)
+    {
+        // ASCII files start with "solid", but so do some binary ones, hence the check of the size first
+        const bool ascii = file.getSize() >= 5 && std::memcmp(data, "solid", 5) == 0;
+        std::cout << "Error: the file " << path << (ascii ? " is an ASCII STL, only binary files are supported" : " is truncated") << std::endl;
+        return nullptr;
+    }
+
+    // Weld work counts as much as the decoding in the progress
+    const size_t total = weld ? 2 * numTriangles : numTriangles;
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    std::vector<glm::vec3>& vertices = mesh->getVertices();
+    std::vector<glm::vec3>& normals = mesh->getNormals();
+    std::vector<uint32_t>& indices = mesh->getIndices();
+    vertices.resize(3 * numTriangles);
+    if(!weld) normals.resize(3 * numTriangles);
+    indices.resize(3 * numTriangles);
+
+    const uint8_t* triangles = data + HEADER_SIZE;
+    if(!forBlocks(numTriangles, 0, total, progress, numThreads, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t t = begin; t < end; t++)
+        {
+            const uint8_t* triangle = triangles + t * TRIANGLE_SIZE;
+            std::memcpy(&vertices[3 * t], triangle + sizeof(glm::vec3), 3 * sizeof(glm::vec3));
+            for(uint32_t k = 0; k < 3; k++) indices[3 * t + k] = static_cast<uint32_t>(3 * t + k);
+            if(weld) continue;
+
+            // Some exporters leave the facet normal as zero
+            glm::vec3 normal = loadUnaligned<glm::vec3>(triangle);
+            if(normal == glm::vec3(0.0f))
+            {
+                const glm::vec3 cross = glm::cross(vertices[3 * t + 1] - vertices[3 * t], vertices[3 * t + 2] - vertices[3 * t]);
+                const float length = glm::length(cross);
+                normal = length > 0.0f ? cross / length : glm::vec3(0.0f, 0.0f, 1.0f);
+            }
+            normals[3 * t] = normals[3 * t + 1] = normals[3 * t + 2] = normal;
+        }
+    }))
+    {
+        return nullptr;
+    }
+
+    if(weld)
+    {
+        // The weld itself cannot be interrupted, the cancellation is checked around it
+        mesh->weld(weldEpsilon, numThreads);
+        if(progress && !progress(0.9f)) return nullptr;
+        mesh->computeNormals(numThreads);
+        if(progress && !progress(1.0f)) return nullptr;
+    }
+    else mesh->computeBoundingBox(numThreads);
+    return mesh;
+}
+
+}
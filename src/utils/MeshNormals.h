@@ -0,0 +1,104 @@
+#ifndef MESH_NORMALS_H
+#define MESH_NORMALS_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/MeshSoA.h"
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    // Access to the vec3 arrays of both mesh layouts
+    inline glm::vec3 loadVec3(const std::vector<glm::vec3>& array, size_t i) { return array[i]; }
+    inline void storeVec3(std::vector<glm::vec3>& array, size_t i, const glm::vec3& v) { array[i] = v; }
+    inline glm::vec3 loadVec3(const Vec3Array& array, size_t i) { return array.get(i); }
+    inline void storeVec3(Vec3Array& array, size_t i, const glm::vec3& v) { array.set(i, v); }
+
+    // Read only array that is not owned, like the ones of a MappedMesh
+    struct Vec3View
+    {
+        const glm::vec3* data;
+        size_t count;
+        size_t size() const { return count; }
+    };
+    inline glm::vec3 loadVec3(const Vec3View& array, size_t i) { return array.data[i]; }
+
+    template<typename VertexArray, typename NormalArray>
+    void computeNormals(const VertexArray& vertices, const std::vector<uint32_t>& indices,
+                        NormalArray& normals, uint32_t numThreads)
+    {
+        const size_t numVertices = vertices.size();
+        const size_t numTriangles = indices.size() / 3;
+
+        auto computeCornerNormals = [&](size_t t, glm::vec3& n1, glm::vec3& n2, glm::vec3& n3)
+        {
+            const glm::vec3 v1 = loadVec3(vertices, indices[3 * t]);
+            const glm::vec3 v2 = loadVec3(vertices, indices[3 * t + 1]);
+            const glm::vec3 v3 = loadVec3(vertices, indices[3 * t + 2]);
+            const glm::vec3 normal = glm::normalize(glm::cross(v2 - v1, v3 - v1));
+
+            const glm::vec3 e12 = glm::normalize(v2 - v1);
+            const glm::vec3 e23 = glm::normalize(v3 - v2);
+            const glm::vec3 e31 = glm::normalize(v1 - v3);
+
+            n1 = glm::acos(glm::clamp(-glm::dot(e12, e31), -1.0f, 1.0f)) * normal;
+            n2 = glm::acos(glm::clamp(-glm::dot(e23, e12), -1.0f, 1.0f)) * normal;
+            n3 = glm::acos(glm::clamp(-glm::dot(e31, e23), -1.0f, 1.0f)) * normal;
+        };
+
+        normals.resize(numVertices);
+
+        if(Parallel::getNumThreads(numThreads) == 1)
+        {
+            // Without concurrency scattering directly is cheaper than building the adjacency
+            for(size_t v = 0; v < numVertices; v++) storeVec3(normals, v, glm::vec3(0.0f));
+            for(size_t t = 0; t < numTriangles; t++)
+            {
+                glm::vec3 n[3];
+                computeCornerNormals(t, n[0], n[1], n[2]);
+                for(uint32_t c = 0; c < 3; c++)
+                {
+                    const uint32_t v = indices[3 * t + c];
+                    storeVec3(normals, v, loadVec3(normals, v) + n[c]);
+                }
+            }
+
+            for(size_t v = 0; v < numVertices; v++) storeVec3(normals, v, glm::normalize(loadVec3(normals, v)));
+            return;
+        }
+
+        // Angle weighted normal of each triangle corner. Every triangle writes only its own corners
+        std::vector<glm::vec3> cornerNormals(3 * numTriangles);
+        Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t t = begin; t < end; t++)
+            {
+                computeCornerNormals(t, cornerNormals[3 * t], cornerNormals[3 * t + 1], cornerNormals[3 * t + 2]);
+            }
+        }, numThreads);
+
+        // Gather the corners of each vertex, no two threads write the same normal
+        const VertexAdjacency adjacency = computeVertexAdjacency(indices, numVertices, numThreads);
+        Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; v++)
+            {
+                glm::vec3 n(0.0f);
+                for(uint32_t c = adjacency.offsets[v]; c < adjacency.offsets[v + 1]; c++)
+                {
+                    n += cornerNormals[adjacency.corners[c]];
+                }
+                storeVec3(normals, v, glm::normalize(n));
+            }
+        }, numThreads);
+    }
+}
+
+}
+
+#endif
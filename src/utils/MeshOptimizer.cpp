@@ -0,0 +1,345 @@
+#include "MyRender/utils/MeshOptimizer.h"
+#include "utils/MeshKernels.h"
+#include "utils/MortonOrder.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    constexpr uint32_t RADIX_BITS = 10;
+    constexpr uint32_t RADIX_BUCKETS = 1u << RADIX_BITS;
+    constexpr size_t RADIX_MIN_CHUNK_SIZE = 1 << 16;
+}
+
+void internal::radixSort(std::vector<uint32_t>& keys, std::vector<uint32_t>& values, uint32_t numThreads)
+{
+    const size_t size = keys.size();
+    const uint32_t numChunks = Parallel::getNumThreads(numThreads);
+    std::vector<uint32_t> tmpKeys(size), tmpValues(size);
+    // Bucket counts and then write positions of each chunk, the chunks are the same in both passes
+    std::vector<size_t> offsets(static_cast<size_t>(numChunks) * RADIX_BUCKETS);
+
+    for(uint32_t shift = 0; shift < 3 * RADIX_BITS; shift += RADIX_BITS)
+    {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        Parallel::forRange(0, size, [&](size_t begin, size_t end, uint32_t chunkId)
+        {
+            size_t* counts = offsets.data() + chunkId * RADIX_BUCKETS;
+            for(size_t i = begin; i < end; i++) counts[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        }, numThreads, RADIX_MIN_CHUNK_SIZE);
+
+        // Buckets in order and, inside each one, the chunks in order keep the sort stable
+        size_t position = 0;
+        bool singleBucket = false;
+        for(uint32_t b = 0; b < RADIX_BUCKETS; b++)
+        {
+            for(uint32_t c = 0; c < numChunks; c++)
+            {
+                const size_t count = offsets[c * RADIX_BUCKETS + b];
+                singleBucket |= count == size;
+                offsets[c * RADIX_BUCKETS + b] = position;
+                position += count;
+            }
+        }
+        // Every key has the same digit, as the high bits of clustered codes often do
+        if(singleBucket) continue;
+
+        Parallel::forRange(0, size, [&](size_t begin, size_t end, uint32_t chunkId)
+        {
+            size_t* positions = offsets.data() + chunkId * RADIX_BUCKETS;
+            for(size_t i = begin; i < end; i++)
+            {
+                const size_t p = positions[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                tmpKeys[p] = keys[i];
+                tmpValues[p] = values[i];
+            }
+        }, numThreads, RADIX_MIN_CHUNK_SIZE);
+        keys.swap(tmpKeys);
+        values.swap(tmpValues);
+    }
+}
+
+namespace MeshOptimizer
+{
+
+VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize)
+{
+    // A vertex is in the FIFO if it entered less than cacheSize misses ago
+    std::vector<size_t> entryTime(numVertices, 0);
+    std::vector<bool> referenced(numVertices, false);
+    size_t time = cacheSize + 1;
+    size_t numReferenced = 0;
+
+    VertexCacheStatistics stats;
+    for(uint32_t v : indices)
+    {
+        if(time - entryTime[v] > cacheSize)
+        {
+            entryTime[v] = time++;
+            stats.vertexShaderInvocations++;
+        }
+
+        if(!referenced[v])
+        {
+            referenced[v] = true;
+            numReferenced++;
+        }
+    }
+
+    const size_t numTriangles = indices.size() / 3;
+    if(numTriangles > 0) stats.acmr = static_cast<float>(stats.vertexShaderInvocations) / static_cast<float>(numTriangles);
+    if(numReferenced > 0) stats.atvr = static_cast<float>(stats.vertexShaderInvocations) / static_cast<float>(numReferenced);
+    return stats;
+}
+
+VertexCacheStatistics analyzeVertexCache(const Mesh& mesh, uint32_t cacheSize)
+{
+    return analyzeVertexCache(mesh.getIndices(), mesh.getVertices().size(), cacheSize);
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize)
+{
+    const size_t numTriangles = indices.size() / 3;
+    if(numTriangles == 0) return;
+
+    const VertexAdjacency adjacency = internal::computeVertexAdjacency(indices, numVertices, 0);
+
+    // Number of triangles not emitted yet that use each vertex
+    std::vector<uint32_t> liveTriangles(numVertices);
+    for(size_t v = 0; v < numVertices; v++) liveTriangles[v] = adjacency.getNumCorners(static_cast<uint32_t>(v));
+
+    std::vector<size_t> cacheTime(numVertices, 0);
+    std::vector<bool> emitted(numTriangles, false);
+    std::vector<uint32_t> deadEndStack;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(3 * numTriangles);
+
+    size_t time = cacheSize + 1;
+    size_t cursor = 0;
+    int64_t fanningVertex = indices[0];
+
+    while(fanningVertex >= 0)
+    {
+        // Emit all the remaining triangles around the fanning vertex
+        candidates.clear();
+        for(uint32_t c = adjacency.offsets[fanningVertex]; c < adjacency.offsets[fanningVertex + 1]; c++)
+        {
+            const uint32_t t = adjacency.corners[c] / 3;
+            if(emitted[t]) continue;
+            emitted[t] = true;
+
+            for(uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t v = indices[3 * t + k];
+                output.push_back(v);
+                deadEndStack.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if(time - cacheTime[v] > cacheSize)
+                {
+                    cacheTime[v] = time++;
+                }
+            }
+        }
+
+        // Next fanning vertex: the one that stays longer in the cache after emitting its triangles
+        fanningVertex = -1;
+        int64_t bestPriority = -1;
+        for(uint32_t v : candidates)
+        {
+            if(liveTriangles[v] == 0) continue;
+            int64_t priority = 0;
+            if(time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+            {
+                priority = static_cast<int64_t>(time - cacheTime[v]);
+            }
+            if(priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanningVertex = v;
+            }
+        }
+
+        // Dead end, take a recently used vertex or else the next one in input order
+        while(fanningVertex < 0 && !deadEndStack.empty())
+        {
+            const uint32_t v = deadEndStack.back();
+            deadEndStack.pop_back();
+            if(liveTriangles[v] > 0) fanningVertex = v;
+        }
+
+        while(fanningVertex < 0 && cursor < 3 * numTriangles)
+        {
+            const uint32_t v = indices[cursor++];
+            if(liveTriangles[v] > 0) fanningVertex = v;
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void optimizeVertexCache(Mesh& mesh, uint32_t cacheSize)
+{
+    optimizeVertexCache(mesh.getIndices(), mesh.getVertices().size(), cacheSize);
+}
+
+float analyzeVertexFetch(const std::vector<uint32_t>& indices, size_t numVertices, size_t vertexSize)
+{
+    constexpr size_t LINE_SIZE = 64;
+    constexpr size_t NUM_CACHE_LINES = 64;
+
+    const size_t numLines = (numVertices * vertexSize + LINE_SIZE - 1) / LINE_SIZE;
+    std::vector<size_t> lineEntryTime(numLines, 0);
+    std::vector<bool> referenced(numVertices, false);
+    size_t time = NUM_CACHE_LINES + 1;
+    size_t numReferenced = 0;
+    size_t fetchedBytes = 0;
+
+    for(uint32_t v : indices)
+    {
+        if(!referenced[v])
+        {
+            referenced[v] = true;
+            numReferenced++;
+        }
+
+        // A vertex can straddle two cache lines
+        const size_t firstLine = (v * vertexSize) / LINE_SIZE;
+        const size_t lastLine = (v * vertexSize + vertexSize - 1) / LINE_SIZE;
+        for(size_t line = firstLine; line <= lastLine; line++)
+        {
+            if(time - lineEntryTime[line] > NUM_CACHE_LINES)
+            {
+                lineEntryTime[line] = time++;
+                fetchedBytes += LINE_SIZE;
+            }
+        }
+    }
+
+    if(numReferenced == 0) return 0.0f;
+    return static_cast<float>(fetchedBytes) / static_cast<float>(numReferenced * vertexSize);
+}
+
+std::vector<uint32_t> computeVertexFetchRemap(const std::vector<uint32_t>& indices, size_t numVertices)
+{
+    constexpr uint32_t UNASSIGNED = ~0u;
+    std::vector<uint32_t> remap(numVertices, UNASSIGNED);
+
+    // Single linear pass, the first use order is inherently sequential
+    uint32_t nextIndex = 0;
+    for(uint32_t v : indices)
+    {
+        if(remap[v] == UNASSIGNED) remap[v] = nextIndex++;
+    }
+
+    for(uint32_t& r : remap)
+    {
+        if(r == UNASSIGNED) r = nextIndex++;
+    }
+
+    return remap;
+}
+
+std::vector<uint32_t> computeMortonRemap(const std::vector<glm::vec3>& vertices, const BoundingBox& box, uint32_t numThreads)
+{
+    const internal::MortonEncoder encoder(box);
+    std::vector<uint32_t> keys(vertices.size()), order(vertices.size());
+    Parallel::forRange(0, vertices.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t v = begin; v < end; v++)
+        {
+            keys[v] = encoder.encode(vertices[v]);
+            order[v] = static_cast<uint32_t>(v);
+        }
+    }, numThreads);
+    internal::radixSort(keys, order, numThreads);
+
+    // order[newIndex] = oldIndex, reused as the remap table
+    std::vector<uint32_t>& remap = keys;
+    Parallel::forRange(0, order.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t i = begin; i < end; i++) remap[order[i]] = static_cast<uint32_t>(i);
+    }, numThreads);
+    return remap;
+}
+
+void sortTrianglesMorton(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& vertices, const BoundingBox& box, uint32_t numThreads)
+{
+    const internal::MortonEncoder encoder(box);
+    const size_t numTriangles = indices.size() / 3;
+    std::vector<uint32_t> keys(numTriangles), order(numTriangles);
+    Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t t = begin; t < end; t++)
+        {
+            const glm::vec3 centroid = (vertices[indices[3 * t]] + vertices[indices[3 * t + 1]] + vertices[indices[3 * t + 2]]) / 3.0f;
+            keys[t] = encoder.encode(centroid);
+            order[t] = static_cast<uint32_t>(t);
+        }
+    }, numThreads);
+    internal::radixSort(keys, order, numThreads);
+
+    std::vector<uint32_t> result(indices.size());
+    Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t t = begin; t < end; t++)
+        {
+            std::copy(indices.begin() + 3 * order[t], indices.begin() + 3 * order[t] + 3, result.begin() + 3 * t);
+        }
+    }, numThreads);
+    // A trailing incomplete triangle stays at the end
+    std::copy(indices.begin() + 3 * numTriangles, indices.end(), result.begin() + 3 * numTriangles);
+    indices.swap(result);
+}
+
+std::vector<uint32_t> optimizeSpatialOrder(Mesh& mesh, uint32_t numThreads)
+{
+    if(mesh.getBoundingBox().min.x > mesh.getBoundingBox().max.x) mesh.computeBoundingBox(numThreads);
+    const size_t numVertices = mesh.getVertices().size();
+    std::vector<uint32_t> remap = computeMortonRemap(mesh.getVertices(), mesh.getBoundingBox(), numThreads);
+
+    remapVertexAttribute(mesh.getVertices(), remap, numThreads);
+    if(mesh.getNormals().size() == numVertices) remapVertexAttribute(mesh.getNormals(), remap, numThreads);
+    if(mesh.getTexCoords().size() == numVertices) remapVertexAttribute(mesh.getTexCoords(), remap, numThreads);
+    if(mesh.getTangents().size() == numVertices) remapVertexAttribute(mesh.getTangents(), remap, numThreads);
+    remapIndices(mesh.getIndices(), remap, numThreads);
+
+    sortTrianglesMorton(mesh.getIndices(), mesh.getVertices(), mesh.getBoundingBox(), numThreads);
+    return remap;
+}
+
+void remapIndices(std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap, uint32_t numThreads)
+{
+    Parallel::forRange(0, indices.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t i = begin; i < end; i++) indices[i] = remap[indices[i]];
+    }, numThreads);
+}
+
+std::vector<uint32_t> optimizeVertexFetch(Mesh& mesh, uint32_t numThreads)
+{
+    std::vector<uint32_t> remap = computeVertexFetchRemap(mesh.getIndices(), mesh.getVertices().size());
+
+    remapVertexAttribute(mesh.getVertices(), remap, numThreads);
+    if(mesh.getNormals().size() == mesh.getVertices().size())
+    {
+        remapVertexAttribute(mesh.getNormals(), remap, numThreads);
+    }
+    if(mesh.getTexCoords().size() == mesh.getVertices().size())
+    {
+        remapVertexAttribute(mesh.getTexCoords(), remap, numThreads);
+    }
+    if(mesh.getTangents().size() == mesh.getVertices().size())
+    {
+        remapVertexAttribute(mesh.getTangents(), remap, numThreads);
+    }
+    remapIndices(mesh.getIndices(), remap, numThreads);
+
+    return remap;
+}
+
+}
+
+}
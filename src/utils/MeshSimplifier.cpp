@@ -0,0 +1,393 @@
+#include "MyRender/utils/MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    // Sum of squared distances to a set of weighted planes, stored as the upper half of a symmetric 4x4 matrix
+    struct Quadric
+    {
+        double a2 = 0.0, b2 = 0.0, c2 = 0.0, d2 = 0.0;
+        double ab = 0.0, ac = 0.0, ad = 0.0;
+        double bc = 0.0, bd = 0.0, cd = 0.0;
+        double weight = 0.0;
+
+        void addPlane(const glm::vec3& normal, const glm::vec3& point, float w)
+        {
+            const double a = normal.x, b = normal.y, c = normal.z;
+            const double d = -glm::dot(normal, point);
+            a2 += w * a * a; b2 += w * b * b; c2 += w * c * c; d2 += w * d * d;
+            ab += w * a * b; ac += w * a * c; ad += w * a * d;
+            bc += w * b * c; bd += w * b * d; cd += w * c * d;
+            weight += w;
+        }
+
+        void add(const Quadric& q)
+        {
+            a2 += q.a2; b2 += q.b2; c2 += q.c2; d2 += q.d2;
+            ab += q.ab; ac += q.ac; ad += q.ad;
+            bc += q.bc; bd += q.bd; cd += q.cd;
+            weight += q.weight;
+        }
+
+        // Weighted mean of the squared distances to the planes
+        float getError(const glm::vec3& p) const
+        {
+            const double x = p.x, y = p.y, z = p.z;
+            const double e = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+                             2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+            return static_cast<float>(glm::max(e, 0.0) / (weight > 0.0 ? weight : 1.0));
+        }
+    };
+
+    enum class VertexKind : uint8_t
+    {
+        MANIFOLD, // Can collapse to any neighbour
+        BORDER,   // On an open border, can only collapse along it
+        LOCKED    // Seams, non manifold vertices and corners of the border
+    };
+
+    // Corner helpers of a triangle list
+    inline uint32_t nextCorner(uint32_t c) { return c - c % 3 + (c + 1) % 3; }
+    inline uint32_t prevCorner(uint32_t c) { return c - c % 3 + (c + 2) % 3; }
+
+    inline bool hasDirectedEdge(const std::vector<uint32_t>& indices, const VertexAdjacency& adjacency,
+                                uint32_t from, uint32_t to)
+    {
+        for(uint32_t c = adjacency.offsets[from]; c < adjacency.offsets[from + 1]; c++)
+        {
+            if(indices[nextCorner(adjacency.corners[c])] == to) return true;
+        }
+        return false;
+    }
+
+    // Marks the vertices that share their position with another vertex
+    std::vector<bool> findSeamVertices(const std::vector<glm::vec3>& vertices)
+    {
+        std::vector<uint32_t> order(vertices.size());
+        for(uint32_t v = 0; v < order.size(); v++) order[v] = v;
+        auto less = [&](uint32_t a, uint32_t b)
+        {
+            const glm::vec3& pa = vertices[a];
+            const glm::vec3& pb = vertices[b];
+            if(pa.x != pb.x) return pa.x < pb.x;
+            if(pa.y != pb.y) return pa.y < pb.y;
+            return pa.z < pb.z;
+        };
+        std::sort(order.begin(), order.end(), less);
+
+        std::vector<bool> seam(vertices.size(), false);
+        for(size_t i = 1; i < order.size(); i++)
+        {
+            if(vertices[order[i]] == vertices[order[i - 1]])
+            {
+                seam[order[i]] = true;
+                seam[order[i - 1]] = true;
+            }
+        }
+        return seam;
+    }
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        float cost;
+    };
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<uint32_t>& indices, const std::vector<glm::vec3>& vertices,
+                                               size_t targetNumIndices, float targetError, float* resultError,
+                                               uint32_t numThreads)
+{
+    using namespace internal;
+    constexpr float BORDER_WEIGHT = 10.0f;
+
+    const size_t numVertices = vertices.size();
+    std::vector<uint32_t> result(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+    float maxCost = 0.0f;
+
+    // Work in a unit box so the errors are relative to the mesh size
+    const BoundingBox box = internal::computeBoundingBox(vertices.data(), numVertices);
+    const float extent = glm::max(box.getSize().x, glm::max(box.getSize().y, box.getSize().z));
+    const float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+    std::vector<glm::vec3> positions(numVertices);
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t v = begin; v < end; v++) positions[v] = (vertices[v] - box.min) * scale;
+    }, numThreads);
+
+    const std::vector<bool> seam = findSeamVertices(vertices);
+
+    // Quadrics of the triangle planes weighted by area plus planes perpendicular to the open borders
+    std::vector<Quadric> quadrics(numVertices);
+    {
+        const VertexAdjacency adjacency = internal::computeVertexAdjacency(result, numVertices, numThreads);
+        Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; v++)
+            {
+                for(uint32_t c = adjacency.offsets[v]; c < adjacency.offsets[v + 1]; c++)
+                {
+                    const uint32_t corner = adjacency.corners[c];
+                    const uint32_t next = result[nextCorner(corner)];
+                    const uint32_t prev = result[prevCorner(corner)];
+                    const glm::vec3& p0 = positions[v];
+                    const glm::vec3& p1 = positions[next];
+                    const glm::vec3& p2 = positions[prev];
+                    const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+                    const float length = glm::length(cross);
+                    if(length == 0.0f) continue;
+                    const glm::vec3 normal = cross / length;
+                    quadrics[v].addPlane(normal, p0, 0.5f * length);
+
+                    // Outgoing and incoming edges of the vertex without an opposite half edge
+                    if(!hasDirectedEdge(result, adjacency, next, static_cast<uint32_t>(v)))
+                    {
+                        const glm::vec3 edge = p1 - p0;
+                        const glm::vec3 edgeNormal = glm::normalize(glm::cross(edge, normal));
+                        quadrics[v].addPlane(edgeNormal, p0, BORDER_WEIGHT * glm::dot(edge, edge));
+                    }
+                    if(!hasDirectedEdge(result, adjacency, static_cast<uint32_t>(v), prev))
+                    {
+                        const glm::vec3 edge = p0 - p2;
+                        const glm::vec3 edgeNormal = glm::normalize(glm::cross(edge, normal));
+                        quadrics[v].addPlane(edgeNormal, p0, BORDER_WEIGHT * glm::dot(edge, edge));
+                    }
+                }
+            }
+        }, numThreads);
+    }
+
+    std::vector<uint32_t> remap(numVertices);
+    for(uint32_t v = 0; v < numVertices; v++) remap[v] = v;
+    std::vector<VertexKind> kinds(numVertices);
+    std::vector<bool> locked(numVertices);
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> collapsed;
+    std::vector<uint32_t> fromRing;
+    std::vector<uint32_t> toRing;
+
+    const float maxAllowedCost = targetError < std::sqrt(std::numeric_limits<float>::max())
+                                 ? targetError * targetError : std::numeric_limits<float>::max();
+
+    while(result.size() > targetNumIndices)
+    {
+        const size_t numTriangles = result.size() / 3;
+        const VertexAdjacency adjacency = internal::computeVertexAdjacency(result, numVertices, numThreads);
+
+        Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; v++)
+            {
+                VertexKind kind = seam[v] ? VertexKind::LOCKED : VertexKind::MANIFOLD;
+                uint32_t numBorderEdges = 0;
+                for(uint32_t c = adjacency.offsets[v]; c < adjacency.offsets[v + 1] && kind != VertexKind::LOCKED; c++)
+                {
+                    const uint32_t next = result[nextCorner(adjacency.corners[c])];
+                    const uint32_t prev = result[prevCorner(adjacency.corners[c])];
+
+                    uint32_t numSame = 0;
+                    for(uint32_t c2 = adjacency.offsets[v]; c2 < adjacency.offsets[v + 1]; c2++)
+                    {
+                        if(result[nextCorner(adjacency.corners[c2])] == next) numSame++;
+                    }
+                    uint32_t numOpposite = 0;
+                    for(uint32_t c2 = adjacency.offsets[next]; c2 < adjacency.offsets[next + 1]; c2++)
+                    {
+                        if(result[nextCorner(adjacency.corners[c2])] == v) numOpposite++;
+                    }
+
+                    if(numSame > 1 || numOpposite > 1) kind = VertexKind::LOCKED;
+                    if(numOpposite == 0) numBorderEdges++;
+                    if(!hasDirectedEdge(result, adjacency, static_cast<uint32_t>(v), prev)) numBorderEdges++;
+                }
+
+                if(kind == VertexKind::MANIFOLD && numBorderEdges > 0)
+                {
+                    kind = numBorderEdges == 2 ? VertexKind::BORDER : VertexKind::LOCKED;
+                }
+                kinds[v] = kind;
+            }
+        }, numThreads);
+
+        // Cheapest allowed direction of each edge. Interior edges are visited from the triangle where a < b
+        std::vector<Collapse> edges(3 * numTriangles);
+        Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t t = begin; t < end; t++)
+            {
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    Collapse& collapse = edges[3 * t + k];
+                    collapse.cost = INFINITY;
+
+                    const uint32_t a = result[3 * t + k];
+                    const uint32_t b = result[3 * t + (k + 1) % 3];
+                    const bool isBorder = !hasDirectedEdge(result, adjacency, b, a);
+                    if(!isBorder && a > b) continue;
+
+                    auto canCollapse = [&](uint32_t from)
+                    {
+                        return kinds[from] == VertexKind::MANIFOLD || (kinds[from] == VertexKind::BORDER && isBorder);
+                    };
+
+                    if(canCollapse(a))
+                    {
+                        collapse = {a, b, quadrics[a].getError(positions[b])};
+                    }
+                    if(canCollapse(b))
+                    {
+                        const float cost = quadrics[b].getError(positions[a]);
+                        if(cost < collapse.cost) collapse = {b, a, cost};
+                    }
+                }
+            }
+        }, numThreads);
+
+        candidates.clear();
+        for(const Collapse& collapse : edges)
+        {
+            if(collapse.cost <= maxAllowedCost) candidates.push_back(collapse);
+        }
+        if(candidates.empty()) break;
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b)
+        {
+            return a.cost < b.cost || (a.cost == b.cost && a.from < b.from);
+        });
+
+        // Every interior collapse removes two triangles. The ones far above the cost of the goal
+        // wait for the next pass, when the cheaper ones of the locked regions may be available
+        const size_t targetNumTriangles = targetNumIndices / 3;
+        const size_t triangleGoal = numTriangles - targetNumTriangles;
+        const float passCostLimit = 1.5f * candidates[std::min(candidates.size() - 1, triangleGoal / 2)].cost;
+
+        std::fill(locked.begin(), locked.end(), false);
+        collapsed.clear();
+        size_t numRemovedTriangles = 0;
+
+        for(const Collapse& collapse : candidates)
+        {
+            if(numRemovedTriangles >= triangleGoal) break;
+            if(collapse.cost > passCostLimit && !collapsed.empty()) break;
+
+            const uint32_t from = collapse.from;
+            const uint32_t to = collapse.to;
+            if(locked[from] || locked[to]) continue;
+
+            // Link condition: the common neighbours must be exactly the opposite vertices of the shared triangles,
+            // otherwise the collapse would create non manifold edges
+            fromRing.clear();
+            toRing.clear();
+            uint32_t numShared = 0;
+            for(uint32_t c = adjacency.offsets[from]; c < adjacency.offsets[from + 1]; c++)
+            {
+                const uint32_t next = result[nextCorner(adjacency.corners[c])];
+                const uint32_t prev = result[prevCorner(adjacency.corners[c])];
+                if(next == to || prev == to) numShared++;
+                fromRing.push_back(next);
+                fromRing.push_back(prev);
+            }
+            for(uint32_t c = adjacency.offsets[to]; c < adjacency.offsets[to + 1]; c++)
+            {
+                toRing.push_back(result[nextCorner(adjacency.corners[c])]);
+                toRing.push_back(result[prevCorner(adjacency.corners[c])]);
+            }
+            std::sort(fromRing.begin(), fromRing.end());
+            fromRing.erase(std::unique(fromRing.begin(), fromRing.end()), fromRing.end());
+            std::sort(toRing.begin(), toRing.end());
+            toRing.erase(std::unique(toRing.begin(), toRing.end()), toRing.end());
+
+            uint32_t numCommon = 0;
+            for(size_t i = 0, j = 0; i < fromRing.size() && j < toRing.size();)
+            {
+                if(fromRing[i] < toRing[j]) i++;
+                else if(toRing[j] < fromRing[i]) j++;
+                else { numCommon++; i++; j++; }
+            }
+            if(numCommon != numShared) continue;
+
+            // The remaining triangles around from must not flip or degenerate
+            bool flips = false;
+            for(uint32_t c = adjacency.offsets[from]; c < adjacency.offsets[from + 1] && !flips; c++)
+            {
+                const uint32_t next = result[nextCorner(adjacency.corners[c])];
+                const uint32_t prev = result[prevCorner(adjacency.corners[c])];
+                if(next == to || prev == to) continue;
+
+                const glm::vec3 oldNormal = glm::cross(positions[next] - positions[from], positions[prev] - positions[from]);
+                const glm::vec3 newNormal = glm::cross(positions[next] - positions[to], positions[prev] - positions[to]);
+                const float oldLength = glm::length(oldNormal);
+                if(oldLength == 0.0f) continue;
+                flips = glm::dot(oldNormal, newNormal) <= 1e-2f * oldLength * glm::length(newNormal);
+            }
+            if(flips) continue;
+
+            remap[from] = to;
+            quadrics[to].add(quadrics[from]);
+            collapsed.push_back(from);
+            numRemovedTriangles += numShared;
+            maxCost = glm::max(maxCost, collapse.cost);
+
+            // The one ring of from changes, so its vertices wait for the next pass
+            for(uint32_t v : fromRing) locked[v] = true;
+            locked[from] = true;
+        }
+
+        if(collapsed.empty()) break;
+
+        Parallel::forRange(0, result.size(), [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t i = begin; i < end; i++) result[i] = remap[result[i]];
+        }, numThreads);
+        for(uint32_t v : collapsed) remap[v] = v;
+
+        size_t numIndices = 0;
+        for(size_t t = 0; t < numTriangles; t++)
+        {
+            const uint32_t a = result[3 * t], b = result[3 * t + 1], c = result[3 * t + 2];
+            if(a == b || b == c || c == a) continue;
+            result[numIndices++] = a;
+            result[numIndices++] = b;
+            result[numIndices++] = c;
+        }
+        result.resize(numIndices);
+    }
+
+    if(resultError != nullptr) *resultError = std::sqrt(maxCost);
+    return result;
+}
+
+std::vector<MeshSimplifier::MeshLod> MeshSimplifier::buildLodChain(const Mesh& mesh, const std::vector<float>& triangleRatios,
+                                                                   uint32_t numThreads)
+{
+    std::vector<MeshLod> lods(1);
+    lods[0].indices = mesh.getIndices();
+    const size_t numTriangles = mesh.getIndices().size() / 3;
+
+    for(float ratio : triangleRatios)
+    {
+        const MeshLod& previous = lods.back();
+        const size_t targetNumIndices = 3 * static_cast<size_t>(ratio * static_cast<float>(numTriangles));
+        if(targetNumIndices >= previous.indices.size()) continue;
+
+        MeshLod lod;
+        float error = 0.0f;
+        lod.indices = simplify(previous.indices, mesh.getVertices(), targetNumIndices,
+                               std::numeric_limits<float>::max(), &error, numThreads);
+        if(lod.indices.size() >= previous.indices.size()) break;
+
+        // Each level is simplified from the previous one, so the errors add up
+        lod.error = previous.error + error;
+        lods.push_back(std::move(lod));
+    }
+
+    return lods;
+}
+
+}
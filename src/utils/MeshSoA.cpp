@@ -0,0 +1,89 @@
+#include "MyRender/utils/MeshSoA.h"
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+#include "utils/MeshNormals.h"
+
+namespace myrender
+{
+
+void Vec3Array::assign(const glm::vec3* src, size_t size, uint32_t numThreads)
+{
+    resize(size);
+    Parallel::forRange(0, size, [&](size_t begin, size_t end, uint32_t)
+    {
+        internal::deinterleave(src + begin, end - begin, x.data() + begin, y.data() + begin, z.data() + begin);
+    }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+}
+
+void Vec3Array::copyTo(glm::vec3* dst, uint32_t numThreads) const
+{
+    Parallel::forRange(0, size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        internal::interleave(x.data() + begin, y.data() + begin, z.data() + begin, end - begin, dst + begin);
+    }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+}
+
+MeshSoA::MeshSoA(const Mesh& mesh, uint32_t numThreads)
+    : mIndices(mesh.getIndices()),
+      mBBox(mesh.getBoundingBox())
+{
+    mVertices.assign(mesh.getVertices().data(), mesh.getVertices().size(), numThreads);
+    mNormals.assign(mesh.getNormals().data(), mesh.getNormals().size(), numThreads);
+}
+
+void MeshSoA::toMesh(Mesh& mesh, uint32_t numThreads) const
+{
+    std::vector<glm::vec3>& vertices = mesh.mVertices.rewrite();
+    vertices.resize(mVertices.size());
+    mVertices.copyTo(vertices.data(), numThreads);
+    std::vector<glm::vec3>& normals = mesh.mNormals.rewrite();
+    normals.resize(mNormals.size());
+    mNormals.copyTo(normals.data(), numThreads);
+    mesh.mIndices.rewrite() = mIndices;
+    mesh.mBBox = mBBox;
+}
+
+Mesh MeshSoA::toMesh(uint32_t numThreads) const
+{
+    Mesh mesh;
+    toMesh(mesh, numThreads);
+    return mesh;
+}
+
+void MeshSoA::computeBoundingBox(uint32_t numThreads)
+{
+    std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(numThreads));
+    Parallel::forRange(0, mVertices.size(), [&](size_t begin, size_t end, uint32_t chunkId)
+    {
+        chunkBoxes[chunkId] = internal::computeBoundingBox(mVertices.x.data() + begin, mVertices.y.data() + begin,
+                                                           mVertices.z.data() + begin, end - begin);
+    }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+
+    mBBox = BoundingBox();
+    for(const BoundingBox& box : chunkBoxes) mBBox.addBoundingBox(box);
+}
+
+void MeshSoA::computeNormals(uint32_t numThreads)
+{
+    internal::computeNormals(mVertices, mIndices, mNormals, numThreads);
+}
+
+VertexAdjacency MeshSoA::computeVertexAdjacency(uint32_t numThreads) const
+{
+    return internal::computeVertexAdjacency(mIndices, mVertices.size(), numThreads);
+}
+
+void MeshSoA::applyTransform(glm::mat4 trans, uint32_t numThreads)
+{
+    std::vector<BoundingBox> chunkBoxes(Parallel::getNumThreads(numThreads));
+    Parallel::forRange(0, mVertices.size(), [&](size_t begin, size_t end, uint32_t chunkId)
+    {
+        chunkBoxes[chunkId] = internal::transformAndComputeBoundingBox(mVertices.x.data() + begin, mVertices.y.data() + begin,
+                                                                       mVertices.z.data() + begin, end - begin, trans);
+    }, numThreads, Mesh::PARALLEL_KERNELS_MIN_VERTICES);
+
+    mBBox = BoundingBox();
+    for(const BoundingBox& box : chunkBoxes) mBBox.addBoundingBox(box);
+}
+
+}
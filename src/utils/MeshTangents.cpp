@@ -0,0 +1,118 @@
+#include <iostream>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    // Unit vector perpendicular to the normal, used when the texture coordinates give no direction
+    glm::vec3 getAnyTangent(const glm::vec3& normal)
+    {
+        const glm::vec3 axis = glm::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        return glm::normalize(glm::cross(axis, normal));
+    }
+
+    // Tangent of each corner of the triangle projected on the plane of the vertex normal and weighted by the
+    // corner angle, as MikkTSpace does before merging them. w is the bitangent sign weighted the same way
+    void computeCornerTangents(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec3>& normals,
+                               const std::vector<glm::vec2>& texCoords, const uint32_t* triangle, glm::vec4* tangents)
+    {
+        const glm::vec3 p[3] = {vertices[triangle[0]], vertices[triangle[1]], vertices[triangle[2]]};
+        const glm::vec2 t1 = texCoords[triangle[1]] - texCoords[triangle[0]];
+        const glm::vec2 t2 = texCoords[triangle[2]] - texCoords[triangle[0]];
+        const float signedArea = t1.x * t2.y - t1.y * t2.x;
+        glm::vec3 direction = t2.y * (p[1] - p[0]) - t1.y * (p[2] - p[0]);
+        if(signedArea < 0.0f) direction = -direction;
+        const float sign = signedArea < 0.0f ? -1.0f : 1.0f;
+
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            tangents[c] = glm::vec4(0.0f);
+            const glm::vec3 e0 = p[(c + 1) % 3] - p[c];
+            const glm::vec3 e1 = p[(c + 2) % 3] - p[c];
+            const float length0 = glm::length(e0), length1 = glm::length(e1);
+            if(signedArea == 0.0f || length0 == 0.0f || length1 == 0.0f) continue;
+
+            const glm::vec3 normal = normals[triangle[c]];
+            const glm::vec3 projected = direction - glm::dot(direction, normal) * normal;
+            const float length = glm::length(projected);
+            if(!(length > 0.0f)) continue;
+
+            const float angle = glm::acos(glm::clamp(glm::dot(e0, e1) / (length0 * length1), -1.0f, 1.0f));
+            tangents[c] = glm::vec4((angle / length) * projected, sign * angle);
+        }
+    }
+
+    glm::vec4 getVertexTangent(const glm::vec4& sum, const glm::vec3& normal)
+    {
+        const glm::vec3 projected = glm::vec3(sum) - glm::dot(glm::vec3(sum), normal) * normal;
+        const float length = glm::length(projected);
+        const glm::vec3 tangent = length > 0.0f ? projected / length : getAnyTangent(normal);
+        return glm::vec4(tangent, sum.w < 0.0f ? -1.0f : 1.0f);
+    }
+}
+
+bool Mesh::computeTangents(uint32_t numThreads)
+{
+    const std::vector<glm::vec3>& vertices = mVertices.get();
+    const std::vector<uint32_t>& indices = mIndices.get();
+    const std::vector<glm::vec2>& texCoords = mTexCoords.get();
+    const size_t numVertices = vertices.size();
+    const size_t numTriangles = indices.size() / 3;
+    if(texCoords.size() != numVertices)
+    {
+        std::cout << "Error: tangents need one texture coordinate per vertex" << std::endl;
+        return false;
+    }
+    if(mNormals.size() != numVertices) computeNormals(numThreads);
+    const std::vector<glm::vec3>& normals = mNormals.get();
+
+    std::vector<glm::vec4>& tangents = mTangents.rewrite();
+    tangents.resize(numVertices);
+
+    if(Parallel::getNumThreads(numThreads) == 1)
+    {
+        // Without concurrency scattering directly is cheaper than building the adjacency
+        std::fill(tangents.begin(), tangents.end(), glm::vec4(0.0f));
+        for(size_t t = 0; t < numTriangles; t++)
+        {
+            glm::vec4 corners[3];
+            internal::computeCornerTangents(vertices, normals, texCoords, indices.data() + 3 * t, corners);
+            for(uint32_t c = 0; c < 3; c++) tangents[indices[3 * t + c]] += corners[c];
+        }
+
+        for(size_t v = 0; v < numVertices; v++) tangents[v] = internal::getVertexTangent(tangents[v], normals[v]);
+        return true;
+    }
+
+    // Every triangle writes only its own corners, then each vertex gathers its corners
+    std::vector<glm::vec4> cornerTangents(3 * numTriangles);
+    Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t t = begin; t < end; t++)
+        {
+            internal::computeCornerTangents(vertices, normals, texCoords, indices.data() + 3 * t, cornerTangents.data() + 3 * t);
+        }
+    }, numThreads);
+
+    const VertexAdjacency adjacency = internal::computeVertexAdjacency(indices, numVertices, numThreads);
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t v = begin; v < end; v++)
+        {
+            glm::vec4 sum(0.0f);
+            for(uint32_t c = adjacency.offsets[v]; c < adjacency.offsets[v + 1]; c++)
+            {
+                sum += cornerTangents[adjacency.corners[c]];
+            }
+            tangents[v] = internal::getVertexTangent(sum, normals[v]);
+        }
+    }, numThreads);
+
+    return true;
+}
+
+}
@@ -0,0 +1,229 @@
+#include <atomic>
+#include <memory>
+#include "MyRender/utils/Mesh.h"
+#include "MyRender/utils/Parallel.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    // Uniform grid over the vertices stored in an open addressing hash table. Each slot holds
+    // one vertex of a cell and the rest of vertices of the cell are linked through nextInCell
+    class WeldGrid
+    {
+    public:
+        static constexpr uint32_t EMPTY = ~0u;
+        static constexpr uint32_t BITS_PER_AXIS = 21;
+
+        WeldGrid(const std::vector<glm::vec3>& vertices, const BoundingBox& box, float epsilon)
+            : mVertices(vertices),
+              mOrigin(box.min)
+        {
+            // The cells must be at least epsilon wide so the 27 neighbouring cells contain all the candidates
+            const float maxSize = glm::max(box.getSize().x, glm::max(box.getSize().y, box.getSize().z));
+            mCellSize = glm::max(epsilon, maxSize / static_cast<float>((1u << BITS_PER_AXIS) - 2));
+            if(!(mCellSize > 0.0f)) mCellSize = 1.0f;
+
+            size_t capacity = 1;
+            while(capacity < 2 * vertices.size()) capacity <<= 1;
+            mMask = capacity - 1;
+            mSlots.reset(new std::atomic<uint32_t>[capacity]);
+            mNextInCell.reset(new uint32_t[vertices.size()]);
+        }
+
+        void clear(uint32_t numThreads)
+        {
+            Parallel::forRange(0, mMask + 1, [&](size_t begin, size_t end, uint32_t)
+            {
+                for(size_t s = begin; s < end; s++) mSlots[s].store(EMPTY, std::memory_order_relaxed);
+            }, numThreads);
+        }
+
+        glm::ivec3 getCell(uint32_t vertexId) const
+        {
+            return glm::ivec3(glm::floor((mVertices[vertexId] - mOrigin) / mCellSize));
+        }
+
+        static uint64_t getKey(const glm::ivec3& cell)
+        {
+            return static_cast<uint64_t>(cell.x) |
+                   (static_cast<uint64_t>(cell.y) << BITS_PER_AXIS) |
+                   (static_cast<uint64_t>(cell.z) << (2 * BITS_PER_AXIS));
+        }
+
+        static size_t hash(uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdull;
+            key ^= key >> 33;
+            return static_cast<size_t>(key);
+        }
+
+        // Thread safe insertion
+        void insert(uint32_t vertexId)
+        {
+            const uint64_t key = getKey(getCell(vertexId));
+            size_t slot = hash(key) & mMask;
+            while(true)
+            {
+                uint32_t head = mSlots[slot].load(std::memory_order_acquire);
+                if(head == EMPTY)
+                {
+                    mNextInCell[vertexId] = EMPTY;
+                    if(mSlots[slot].compare_exchange_weak(head, vertexId, std::memory_order_acq_rel)) return;
+                    continue;
+                }
+
+                if(getKey(getCell(head)) == key)
+                {
+                    // Push at the front of the cell list
+                    mNextInCell[vertexId] = head;
+                    if(mSlots[slot].compare_exchange_weak(head, vertexId, std::memory_order_acq_rel)) return;
+                    continue;
+                }
+
+                slot = (slot + 1) & mMask;
+            }
+        }
+
+        // First vertex of the cell or EMPTY. Only valid once all the insertions have finished
+        uint32_t getCellHead(const glm::ivec3& cell) const
+        {
+            const uint64_t key = getKey(cell);
+            size_t slot = hash(key) & mMask;
+            while(true)
+            {
+                const uint32_t head = mSlots[slot].load(std::memory_order_relaxed);
+                if(head == EMPTY || getKey(getCell(head)) == key) return head;
+                slot = (slot + 1) & mMask;
+            }
+        }
+
+        uint32_t getNextInCell(uint32_t vertexId) const { return mNextInCell[vertexId]; }
+
+    private:
+        const std::vector<glm::vec3>& mVertices;
+        glm::vec3 mOrigin;
+        float mCellSize;
+        size_t mMask;
+        std::unique_ptr<std::atomic<uint32_t>[]> mSlots;
+        std::unique_ptr<uint32_t[]> mNextInCell;
+    };
+}
+
+std::vector<uint32_t> Mesh::weld(float epsilon, uint32_t numThreads, float texCoordEpsilon)
+{
+    // Every array is compacted in place, so the shared ones are copied first
+    std::vector<glm::vec3>& vertices = mVertices.edit();
+    std::vector<uint32_t>& indices = mIndices.edit();
+    std::vector<glm::vec3>& normals = mNormals.edit();
+    std::vector<glm::vec2>& texCoords = mTexCoords.edit();
+    std::vector<glm::vec4>& tangents = mTangents.edit();
+    const size_t numVertices = vertices.size();
+    const bool hasNormals = normals.size() == numVertices;
+    const bool hasTexCoords = texCoords.size() == numVertices;
+    const bool hasTangents = tangents.size() == numVertices;
+    const float epsilon2 = epsilon * epsilon;
+    const float texCoordEpsilon2 = texCoordEpsilon * texCoordEpsilon;
+
+    computeBoundingBox(numThreads);
+
+    internal::WeldGrid grid(vertices, mBBox, epsilon);
+    grid.clear(numThreads);
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t v = begin; v < end; v++) grid.insert(static_cast<uint32_t>(v));
+    }, numThreads);
+
+    // Each vertex points to the lowest index vertex within epsilon, and within texCoordEpsilon in texture
+    // coordinates, which does not depend on the insertion order
+    std::vector<uint32_t> remap(numVertices);
+    Parallel::forRange(0, numVertices, [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t v = begin; v < end; v++)
+        {
+            uint32_t representative = static_cast<uint32_t>(v);
+            const glm::ivec3 cell = grid.getCell(static_cast<uint32_t>(v));
+            for(int i = -1; i <= 1; i++)
+            for(int j = -1; j <= 1; j++)
+            for(int k = -1; k <= 1; k++)
+            {
+                const glm::ivec3 nCell = cell + glm::ivec3(i, j, k);
+                if(nCell.x < 0 || nCell.y < 0 || nCell.z < 0) continue;
+                for(uint32_t u = grid.getCellHead(nCell); u != internal::WeldGrid::EMPTY; u = grid.getNextInCell(u))
+                {
+                    if(u >= representative) continue;
+                    const glm::vec3 diff = vertices[u] - vertices[v];
+                    if(glm::dot(diff, diff) > epsilon2) continue;
+                    // Vertices split along a texture seam keep their own coordinates
+                    if(hasTexCoords)
+                    {
+                        const glm::vec2 texDiff = texCoords[u] - texCoords[v];
+                        if(glm::dot(texDiff, texDiff) > texCoordEpsilon2) continue;
+                    }
+                    representative = u;
+                }
+            }
+            remap[v] = representative;
+        }
+    }, numThreads);
+
+    // The representatives always have a lower index, so a single ordered pass resolves the chains,
+    // numbers the remaining vertices and compacts them in place
+    uint32_t numWelded = 0;
+    for(size_t v = 0; v < numVertices; v++)
+    {
+        if(remap[v] == v)
+        {
+            vertices[numWelded] = vertices[v];
+            if(hasNormals) normals[numWelded] = normals[v];
+            if(hasTexCoords) texCoords[numWelded] = texCoords[v];
+            if(hasTangents) tangents[numWelded] = tangents[v];
+            remap[v] = numWelded++;
+        }
+        else
+        {
+            remap[v] = remap[remap[v]];
+        }
+    }
+    vertices.resize(numWelded);
+    vertices.shrink_to_fit();
+    if(hasNormals)
+    {
+        normals.resize(numWelded);
+        normals.shrink_to_fit();
+    }
+    if(hasTexCoords)
+    {
+        texCoords.resize(numWelded);
+        texCoords.shrink_to_fit();
+    }
+    if(hasTangents)
+    {
+        tangents.resize(numWelded);
+        tangents.shrink_to_fit();
+    }
+
+    Parallel::forRange(0, indices.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t i = begin; i < end; i++) indices[i] = remap[indices[i]];
+    }, numThreads);
+
+    // Remove the collapsed triangles
+    size_t numIndices = 0;
+    for(size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+        const uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+        if(a == b || b == c || c == a) continue;
+        indices[numIndices++] = a;
+        indices[numIndices++] = b;
+        indices[numIndices++] = c;
+    }
+    indices.resize(numIndices);
+
+    computeBoundingBox(numThreads);
+    return remap;
+}
+
+}
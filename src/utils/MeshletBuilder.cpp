@@ -0,0 +1,201 @@
+#include "MyRender/utils/MeshletBuilder.h"
+#include <algorithm>
+#include "MyRender/utils/Parallel.h"
+#include "utils/MeshKernels.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    // Limit of the 8 bit meshlet vertex indices, also used for the triangles
+    constexpr uint32_t MESHLET_MAX_ELEMENTS = 256;
+
+    MeshletBuilder::MeshletBounds computeMeshletBounds(const Mesh& mesh, const MeshletBuilder::MeshletData& data,
+                                                       const MeshletBuilder::Meshlet& meshlet)
+    {
+        const std::vector<glm::vec3>& vertices = mesh.getVertices();
+        MeshletBuilder::MeshletBounds bounds;
+
+        BoundingBox box;
+        for(uint32_t i = 0; i < meshlet.numVertices; i++) box.addPoint(vertices[data.vertices[meshlet.vertexOffset + i]]);
+        bounds.center = box.getCenter();
+        bounds.radius = 0.0f;
+        for(uint32_t i = 0; i < meshlet.numVertices; i++)
+        {
+            bounds.radius = glm::max(bounds.radius, glm::length(vertices[data.vertices[meshlet.vertexOffset + i]] - bounds.center));
+        }
+
+        // The cone axis is the mean triangle normal and its spread is given by the most deviated normal
+        glm::vec3 normals[MESHLET_MAX_ELEMENTS];
+        glm::vec3 points[MESHLET_MAX_ELEMENTS];
+        uint32_t numNormals = 0;
+        glm::vec3 axis(0.0f);
+        for(uint32_t t = 0; t < meshlet.numTriangles; t++)
+        {
+            const glm::uvec3 tri = MeshletBuilder::unpackTriangle(data.triangles[meshlet.triangleOffset + t]);
+            const glm::vec3& p0 = vertices[data.vertices[meshlet.vertexOffset + tri.x]];
+            const glm::vec3& p1 = vertices[data.vertices[meshlet.vertexOffset + tri.y]];
+            const glm::vec3& p2 = vertices[data.vertices[meshlet.vertexOffset + tri.z]];
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float length = glm::length(normal);
+            if(length == 0.0f) continue;
+            normals[numNormals] = normal / length;
+            points[numNormals++] = p0;
+            axis += normal / length;
+        }
+
+        bounds.coneApex = bounds.center;
+        bounds.padding = 0.0f;
+        bounds.coneAxis = glm::vec3(0.0f);
+        bounds.coneCutoff = 1.0f;
+
+        const float axisLength = glm::length(axis);
+        if(axisLength == 0.0f) return bounds;
+        axis /= axisLength;
+
+        float minDot = 1.0f;
+        for(uint32_t i = 0; i < numNormals; i++) minDot = glm::min(minDot, glm::dot(axis, normals[i]));
+
+        // Almost half a sphere of normals, the meshlet is visible from nearly everywhere
+        if(minDot <= 0.1f) return bounds;
+
+        // Apex in the negative half space of all the triangles, so the test is conservative for any camera
+        float maxT = 0.0f;
+        for(uint32_t i = 0; i < numNormals; i++)
+        {
+            const float t = glm::dot(bounds.center - points[i], normals[i]) / glm::dot(axis, normals[i]);
+            maxT = glm::max(maxT, t);
+        }
+
+        bounds.coneApex = bounds.center - axis * maxT;
+        bounds.coneAxis = axis;
+        bounds.coneCutoff = glm::sqrt(1.0f - minDot * minDot);
+        return bounds;
+    }
+}
+
+MeshletBuilder::MeshletData MeshletBuilder::buildMeshlets(const Mesh& mesh, uint32_t maxVertices, uint32_t maxTriangles,
+                                                          uint32_t numThreads)
+{
+    constexpr uint32_t NOT_IN_MESHLET = ~0u;
+    maxVertices = glm::clamp(maxVertices, 3u, internal::MESHLET_MAX_ELEMENTS);
+    maxTriangles = glm::clamp(maxTriangles, 1u, internal::MESHLET_MAX_ELEMENTS);
+
+    const std::vector<uint32_t>& indices = mesh.getIndices();
+    const size_t numVertices = mesh.getVertices().size();
+    const size_t numTriangles = indices.size() / 3;
+    const VertexAdjacency adjacency = internal::computeVertexAdjacency(indices, numVertices, numThreads);
+
+    MeshletData data;
+    data.vertices.reserve(numTriangles + numTriangles / 2);
+    data.triangles.reserve(numTriangles);
+
+    std::vector<uint8_t> emitted(numTriangles, 0);
+    std::vector<uint32_t> localIndex(numVertices, NOT_IN_MESHLET);
+
+    // Triangles not emitted yet around each vertex
+    std::vector<uint32_t> liveTriangles(numVertices);
+    for(size_t v = 0; v < numVertices; v++) liveTriangles[v] = adjacency.getNumCorners(static_cast<uint32_t>(v));
+    Meshlet current = {0, 0, 0, 0};
+
+    auto numNewVertices = [&](size_t t)
+    {
+        return static_cast<uint32_t>(localIndex[indices[3 * t]] == NOT_IN_MESHLET) +
+               static_cast<uint32_t>(localIndex[indices[3 * t + 1]] == NOT_IN_MESHLET) +
+               static_cast<uint32_t>(localIndex[indices[3 * t + 2]] == NOT_IN_MESHLET);
+    };
+
+    auto finishMeshlet = [&]()
+    {
+        if(current.numTriangles == 0) return;
+        for(uint32_t i = 0; i < current.numVertices; i++) localIndex[data.vertices[current.vertexOffset + i]] = NOT_IN_MESHLET;
+        data.meshlets.push_back(current);
+        current = {static_cast<uint32_t>(data.vertices.size()), static_cast<uint32_t>(data.triangles.size()), 0, 0};
+    };
+
+    size_t cursor = 0;
+    int64_t lastTriangle = -1;
+    while(true)
+    {
+        // Prefer the neighbours of the last triangle that add fewer vertices, and then the ones whose vertices
+        // have fewer triangles left, which keeps the meshlets compact instead of growing them as strips
+        int64_t next = -1;
+        uint32_t nextNewVertices = 4;
+        uint32_t nextLiveTriangles = ~0u;
+        if(lastTriangle >= 0)
+        {
+            for(uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t v = indices[3 * lastTriangle + k];
+                for(uint32_t c = adjacency.offsets[v]; c < adjacency.offsets[v + 1]; c++)
+                {
+                    const uint32_t t = adjacency.corners[c] / 3;
+                    if(emitted[t]) continue;
+                    const uint32_t newVertices = numNewVertices(t);
+                    const uint32_t live = liveTriangles[indices[3 * t]] + liveTriangles[indices[3 * t + 1]] +
+                                          liveTriangles[indices[3 * t + 2]];
+                    if(newVertices < nextNewVertices || (newVertices == nextNewVertices && live < nextLiveTriangles))
+                    {
+                        next = t;
+                        nextNewVertices = newVertices;
+                        nextLiveTriangles = live;
+                    }
+                }
+            }
+        }
+
+        // Otherwise continue with the next triangle in index order
+        if(next < 0)
+        {
+            while(cursor < numTriangles && emitted[cursor]) cursor++;
+            if(cursor == numTriangles) break;
+            next = static_cast<int64_t>(cursor);
+            nextNewVertices = numNewVertices(cursor);
+        }
+
+        if(current.numVertices + nextNewVertices > maxVertices || current.numTriangles == maxTriangles)
+        {
+            finishMeshlet();
+        }
+
+        uint32_t local[3];
+        for(uint32_t k = 0; k < 3; k++)
+        {
+            const uint32_t v = indices[3 * next + k];
+            if(localIndex[v] == NOT_IN_MESHLET)
+            {
+                localIndex[v] = current.numVertices++;
+                data.vertices.push_back(v);
+            }
+            local[k] = localIndex[v];
+            liveTriangles[v]--;
+        }
+        data.triangles.push_back(packTriangle(local[0], local[1], local[2]));
+        current.numTriangles++;
+        emitted[next] = 1;
+        lastTriangle = next;
+    }
+    finishMeshlet();
+
+    data.bounds.resize(data.meshlets.size());
+    Parallel::forRange(0, data.meshlets.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t m = begin; m < end; m++) data.bounds[m] = internal::computeMeshletBounds(mesh, data, data.meshlets[m]);
+    }, numThreads);
+
+    return data;
+}
+
+std::vector<MeshletBuilder::MeshletData> MeshletBuilder::buildMeshlets(const std::vector<const Mesh*>& meshes, uint32_t maxVertices,
+                                                                       uint32_t maxTriangles, uint32_t numThreads)
+{
+    std::vector<MeshletData> result(meshes.size());
+    Parallel::forRange(0, meshes.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t m = begin; m < end; m++) result[m] = buildMeshlets(*meshes[m], maxVertices, maxTriangles, 1);
+    }, numThreads, 1);
+    return result;
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef MORTON_ORDER_H
+#define MORTON_ORDER_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/Mesh.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    constexpr uint32_t MORTON_BITS_PER_AXIS = 10;
+
+    // Inserts two zeros after each of the low 10 bits
+    inline uint32_t expandMortonBits(uint32_t v)
+    {
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+    // Maps the points of a box to the 30 bit codes of their cells along the Z-order curve
+    struct MortonEncoder
+    {
+        glm::vec3 origin;
+        glm::vec3 scale;
+
+        explicit MortonEncoder(const BoundingBox& box)
+            : origin(box.min)
+        {
+            const float numCells = static_cast<float>(1u << MORTON_BITS_PER_AXIS);
+            const glm::vec3 size = box.getSize();
+            // Flat axes all fall in the first cell
+            scale = glm::vec3(size.x > 0.0f ? numCells / size.x : 0.0f, size.y > 0.0f ? numCells / size.y : 0.0f,
+                              size.z > 0.0f ? numCells / size.z : 0.0f);
+        }
+
+        uint32_t encode(const glm::vec3& point) const
+        {
+            const float maxCell = static_cast<float>((1u << MORTON_BITS_PER_AXIS) - 1);
+            const glm::vec3 cell = glm::clamp((point - origin) * scale, glm::vec3(0.0f), glm::vec3(maxCell));
+            return expandMortonBits(static_cast<uint32_t>(cell.x)) | expandMortonBits(static_cast<uint32_t>(cell.y)) << 1 |
+                   expandMortonBits(static_cast<uint32_t>(cell.z)) << 2;
+        }
+    };
+
+    // Stable parallel LSD radix sort of the values by their 30 bit keys, sorts both arrays
+    void radixSort(std::vector<uint32_t>& keys, std::vector<uint32_t>& values, uint32_t numThreads);
+}
+
+}
+
+#endif
@@ -1,11 +1,189 @@
 #include "MyRender/utils/PrimitivesFactory.h"
 
-#include <map>
+#include "MyRender/utils/Parallel.h"
+#include <algorithm>
 #include <array>
+#include <cmath>
 
 namespace myrender
 {
 
+namespace internal
+{
+    constexpr size_t SUBDIVISION_MIN_TRIANGLES = 4096;
+    constexpr float PRIMITIVES_PI = 3.14159265358979f;
+
+    // Half edge 3 * t + k goes from corner k to corner k + 1 of triangle t. Returns the half edge going the other
+    // way for each one, the mesh must be closed. Only used on the base mesh, so a quadratic search is fine
+    std::vector<uint32_t> computeTwinHalfEdges(const std::vector<uint32_t>& indices)
+    {
+        std::vector<uint32_t> twins(indices.size(), ~0u);
+        for(size_t h = 0; h < indices.size(); h++)
+        {
+            const uint32_t a = indices[h], b = indices[h - h % 3 + (h + 1) % 3];
+            for(size_t o = 0; o < indices.size(); o++)
+            {
+                if(indices[o] == b && indices[o - o % 3 + (o + 1) % 3] == a) twins[h] = static_cast<uint32_t>(o);
+            }
+        }
+        return twins;
+    }
+
+    // Splits each triangle (v0, v1, v2) in four with the midpoints m0, m1, m2 of its edges pushed to the unit sphere:
+    // (v0, m0, m2), (m0, v1, m1), (m2, m1, v2) and (m0, m1, m2). Each edge is owned by its half edge with the lower
+    // id, which numbers the midpoint, so the twins give the midpoint ids of the shared edges without any lookup.
+    // The twins of the new triangles follow from the ones of the old, which keeps the scheme going level after level
+    void subdivideSphere(uint32_t numVertices, const std::vector<uint32_t>& indices, const std::vector<uint32_t>& twins,
+                         std::vector<glm::vec3>& vertices, std::vector<uint32_t>& edgeIds,
+                         std::vector<uint32_t>& nextIndices, std::vector<uint32_t>& nextTwins, bool computeTwins)
+    {
+        const size_t numTriangles = indices.size() / 3;
+        edgeIds.resize(indices.size());
+
+        // Owned edges per chunk, then their ids and midpoints. Both passes split the triangles the same way
+        const uint32_t numChunks = Parallel::getNumThreads(0);
+        std::vector<uint32_t> chunkEdges(numChunks + 1, 0);
+        Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t chunkId)
+        {
+            uint32_t count = 0;
+            for(size_t h = 3 * begin; h < 3 * end; h++) count += h < twins[h];
+            chunkEdges[chunkId + 1] = count;
+        }, numChunks, SUBDIVISION_MIN_TRIANGLES);
+        for(uint32_t c = 0; c < numChunks; c++) chunkEdges[c + 1] += chunkEdges[c];
+
+        Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t chunkId)
+        {
+            uint32_t edge = chunkEdges[chunkId];
+            for(size_t h = 3 * begin; h < 3 * end; h++)
+            {
+                if(h > twins[h]) continue;
+                edgeIds[h] = edge;
+                const glm::vec3 midpoint = 0.5f * (vertices[indices[h]] + vertices[indices[h - h % 3 + (h + 1) % 3]]);
+                vertices[numVertices + edge] = glm::normalize(midpoint);
+                edge++;
+            }
+        }, numChunks, SUBDIVISION_MIN_TRIANGLES);
+
+        nextIndices.resize(4 * indices.size());
+        if(computeTwins) nextTwins.resize(4 * indices.size());
+        Parallel::forRange(0, numTriangles, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t t = begin; t < end; t++)
+            {
+                const uint32_t* v = &indices[3 * t];
+                uint32_t m[3];
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    const size_t h = 3 * t + k;
+                    m[k] = numVertices + (h < twins[h] ? edgeIds[h] : edgeIds[twins[h]]);
+                }
+
+                uint32_t* child = &nextIndices[12 * t];
+                child[0] = v[0]; child[1] = m[0];  child[2] = m[2];
+                child[3] = m[0]; child[4] = v[1];  child[5] = m[1];
+                child[6] = m[2]; child[7] = m[1];  child[8] = v[2];
+                child[9] = m[0]; child[10] = m[1]; child[11] = m[2];
+                if(!computeTwins) continue;
+
+                // Half edges of the children covering the first and second half of each parent edge
+                const uint32_t first[3] = {0, 4, 8}, second[3] = {3, 7, 2};
+                uint32_t* childTwins = &nextTwins[12 * t];
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    const uint32_t twin = twins[3 * t + k];
+                    const uint32_t twinTriangle = twin / 3, twinEdge = twin % 3;
+                    childTwins[first[k]] = 12 * twinTriangle + second[twinEdge];
+                    childTwins[second[k]] = 12 * twinTriangle + first[twinEdge];
+                }
+                // Inner half edges, shared with the center triangle
+                childTwins[1] = 12 * static_cast<uint32_t>(t) + 11;
+                childTwins[11] = 12 * static_cast<uint32_t>(t) + 1;
+                childTwins[5] = 12 * static_cast<uint32_t>(t) + 9;
+                childTwins[9] = 12 * static_cast<uint32_t>(t) + 5;
+                childTwins[6] = 12 * static_cast<uint32_t>(t) + 10;
+                childTwins[10] = 12 * static_cast<uint32_t>(t) + 6;
+            }
+        }, numChunks, SUBDIVISION_MIN_TRIANGLES);
+    }
+
+    using PrimitivesFactory::PrimitiveVertex;
+
+    // Ring of vertices around the y axis, with the normal (normalRadial * direction, normalY)
+    struct LatheRing
+    {
+        float radius;
+        float y;
+        float normalRadial;
+        float normalY;
+    };
+
+    // (cos, sin) of the angles of the segments in the xz plane, offset in segments
+    std::vector<glm::vec2> getRingDirections(uint32_t segments, float angleOffset)
+    {
+        std::vector<glm::vec2> directions(segments);
+        for(uint32_t i = 0; i < segments; i++)
+        {
+            const float angle = 2.0f * PRIMITIVES_PI * (static_cast<float>(i) + angleOffset) / static_cast<float>(segments);
+            directions[i] = glm::vec2(std::cos(angle), std::sin(angle));
+        }
+        return directions;
+    }
+
+    PrimitiveVertex* writeRing(PrimitiveVertex* vertices, const std::vector<glm::vec2>& directions, const LatheRing& ring)
+    {
+        for(const glm::vec2& d : directions)
+        {
+            *vertices++ = {glm::vec3(ring.radius * d.x, ring.y, ring.radius * d.y), glm::vec3(ring.normalRadial * d.x, ring.normalY, ring.normalRadial * d.y)};
+        }
+        return vertices;
+    }
+
+    // Two triangles per segment between the ring starting at vertex upper and the ring below it starting at lower
+    uint32_t* writeBand(uint32_t* indices, uint32_t upper, uint32_t lower, uint32_t segments)
+    {
+        for(uint32_t i = 0; i < segments; i++)
+        {
+            const uint32_t j = i + 1 < segments ? i + 1 : 0;
+            const uint32_t band[6] = {upper + i, upper + j, lower + j, upper + i, lower + j, lower + i};
+            indices = std::copy(band, band + 6, indices);
+        }
+        return indices;
+    }
+
+    // Triangles between the vertex center and a ring, facing up or down
+    uint32_t* writeFan(uint32_t* indices, uint32_t center, uint32_t ring, uint32_t segments, bool up)
+    {
+        for(uint32_t i = 0; i < segments; i++)
+        {
+            const uint32_t j = i + 1 < segments ? i + 1 : 0;
+            const uint32_t fan[3] = {center, up ? ring + j : ring + i, up ? ring + i : ring + j};
+            indices = std::copy(fan, fan + 3, indices);
+        }
+        return indices;
+    }
+
+    // Surface of revolution closed by a vertex on the axis at both ends, rings go from top to bottom
+    void writeLathe(PrimitiveVertex* vertices, uint32_t* indices, uint32_t segments, float topY, float bottomY, const std::vector<LatheRing>& rings)
+    {
+        const std::vector<glm::vec2> directions = getRingDirections(segments, 0.0f);
+        *vertices++ = {glm::vec3(0.0f, topY, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)};
+        for(const LatheRing& ring : rings) vertices = writeRing(vertices, directions, ring);
+        *vertices = {glm::vec3(0.0f, bottomY, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)};
+
+        const uint32_t numRings = static_cast<uint32_t>(rings.size());
+        indices = writeFan(indices, 0, 1, segments, true);
+        for(uint32_t r = 0; r + 1 < numRings; r++) indices = writeBand(indices, 1 + r * segments, 1 + (r + 1) * segments, segments);
+        writeFan(indices, 1 + numRings * segments, 1 + (numRings - 1) * segments, segments, false);
+    }
+
+    // Counts stored as floats in the description, with a lower bound
+    uint32_t getCount(float parameter, uint32_t minCount)
+    {
+        return std::max(static_cast<uint32_t>(std::max(parameter, 0.0f)), minCount);
+    }
+}
+
+
 namespace PrimitivesFactory
 {
 
@@ -37,68 +215,27 @@ std::shared_ptr<Mesh> getIsosphere(uint32_t subdivisions)
         glm::vec3(-Z, -X, 0.0),
     };
 
-    auto mesh = std::make_shared<Mesh>();
-    mesh->getIndices().assign(isosphereIndices.begin(), isosphereIndices.end());
-    mesh->getVertices().assign(isosphereVertices.begin(), isosphereVertices.end());
+    const size_t numTriangles = isosphereIndices.size() / 3 << (2 * subdivisions);
+    // Euler characteristic of a sphere, V - E + F = 2 with E = 3F / 2
+    const size_t numVertices = numTriangles / 2 + 2;
 
-    if(subdivisions > 0)
+    auto mesh = std::make_shared<Mesh>();
+    std::vector<glm::vec3>& vertices = mesh->getVertices();
+    std::vector<uint32_t>& indices = mesh->getIndices();
+    vertices.resize(numVertices);
+    std::copy(isosphereVertices.begin(), isosphereVertices.end(), vertices.begin());
+    indices.assign(isosphereIndices.begin(), isosphereIndices.end());
+    if(subdivisions == 0) return mesh;
+
+    std::vector<uint32_t> twins = internal::computeTwinHalfEdges(indices);
+    std::vector<uint32_t> nextIndices, nextTwins, edgeIds;
+    uint32_t levelVertices = static_cast<uint32_t>(isosphereVertices.size());
+    for(uint32_t s = 0; s < subdivisions; s++)
     {
-        std::map<std::pair<uint32_t, uint32_t>, uint32_t> edgeMidPointCache;
-
-        std::vector<glm::vec3>& vertices = mesh->getVertices();
-        std::vector<uint32_t>& indices = mesh->getIndices();
-
-        float goldenRatio = (1.0f + glm::sqrt(5.0f)) / 2.0f;
-        goldenRatio = glm::sqrt(goldenRatio * goldenRatio + 1.0f);
-
-        auto getMidEdgeId = [&](uint32_t a, uint32_t b) -> uint32_t
-        {
-            auto edgeId = std::make_pair(glm::min(a, b), glm::max(a, b));
-            auto it = edgeMidPointCache.find(edgeId);
-            if(it != edgeMidPointCache.end())
-            {
-                const uint32_t edgeIndex = it->second;
-                edgeMidPointCache.erase(it);
-                return edgeIndex;
-            }
-            else
-            {
-                glm::vec3 point = 0.5f * (vertices[a] + vertices[b]);
-                vertices.push_back(glm::normalize(point));
-                const uint32_t edgeIndex = vertices.size()-1;
-                edgeMidPointCache[edgeId] = edgeIndex;
-                return edgeIndex;
-            }
-        };
-
-        for(uint32_t s=0; s < subdivisions; s++)
-        {
-			uint32_t oldIndicesSize = indices.size();
-            for(uint32_t t=0; t < oldIndicesSize; t += 3)
-            {
-                uint32_t nv1 = getMidEdgeId(indices[t], indices[t+1]);
-                uint32_t nv2 = getMidEdgeId(indices[t+1], indices[t+2]);
-                uint32_t nv3 = getMidEdgeId(indices[t+2], indices[t]);
-
-                indices.push_back(indices[t]);
-                indices.push_back(nv1);
-                indices.push_back(nv3);
-
-                indices.push_back(nv1);
-                indices.push_back(indices[t+1]);
-                indices.push_back(nv2);
-
-                indices.push_back(nv2);
-                indices.push_back(indices[t+2]);
-                indices.push_back(nv3);
-
-                indices[t] = nv1;
-                indices[t+1] = nv2;
-                indices[t+2] = nv3;
-            }
-
-            edgeMidPointCache.clear();
-        }
+        internal::subdivideSphere(levelVertices, indices, twins, vertices, edgeIds, nextIndices, nextTwins, s + 1 < subdivisions);
+        levelVertices += static_cast<uint32_t>(indices.size() / 2);
+        std::swap(indices, nextIndices);
+        std::swap(twins, nextTwins);
     }
 
     return mesh;
@@ -195,6 +332,253 @@ std::shared_ptr<Mesh> getCube()
 
     return mesh;
 }
+
+std::shared_ptr<Mesh> create(const PrimitiveDesc& desc)
+{
+    switch(desc.type)
+    {
+    case PrimitiveType::ISOSPHERE:
+        return getIsosphere(static_cast<uint32_t>(desc.parameters[0]));
+    case PrimitiveType::PLANE:
+        return getPlane();
+    case PrimitiveType::CUBE:
+        return getCube();
+    default:
+        break;
+    }
+
+    auto mesh = std::make_shared<Mesh>();
+    const PrimitiveSize size = getSize(desc);
+    std::vector<PrimitiveVertex> vertices(size.numVertices);
+    mesh->getIndices().resize(size.numIndices);
+    if(!write(desc, vertices.data(), mesh->getIndices().data())) return mesh;
+
+    std::vector<glm::vec3>& positions = mesh->getVertices();
+    std::vector<glm::vec3>& normals = mesh->getNormals();
+    positions.resize(size.numVertices);
+    normals.resize(size.numVertices);
+    for(uint32_t v = 0; v < size.numVertices; v++)
+    {
+        positions[v] = vertices[v].position;
+        normals[v] = vertices[v].normal;
+    }
+    return mesh;
+}
+
+bool isAnalytic(PrimitiveType type)
+{
+    return type != PrimitiveType::ISOSPHERE && type != PrimitiveType::PLANE && type != PrimitiveType::CUBE;
+}
+
+PrimitiveSize getSize(const PrimitiveDesc& desc)
+{
+    using internal::getCount;
+    const std::array<float, 4>& p = desc.parameters;
+    switch(desc.type)
+    {
+    case PrimitiveType::CYLINDER:
+    {
+        // Caps with a center vertex, the side rings are separate for the hard edges
+        const uint32_t segments = getCount(p[0], 3);
+        return {4 * segments + 2, 12 * segments};
+    }
+    case PrimitiveType::CONE:
+    {
+        // One apex vertex per segment, so each side triangle gets the normal of its middle
+        const uint32_t segments = getCount(p[0], 3);
+        return {3 * segments + 1, 6 * segments};
+    }
+    case PrimitiveType::TORUS:
+    {
+        const uint32_t majorSegments = getCount(p[0], 3), minorSegments = getCount(p[1], 3);
+        return {majorSegments * minorSegments, 6 * majorSegments * minorSegments};
+    }
+    case PrimitiveType::CAPSULE:
+    {
+        const uint32_t segments = getCount(p[0], 3), rings = getCount(p[1], 1);
+        return {2 * rings * segments + 2, 12 * rings * segments};
+    }
+    case PrimitiveType::GRID:
+    {
+        const uint32_t columns = getCount(p[0], 1), rows = getCount(p[1], 1);
+        return {(columns + 1) * (rows + 1), 6 * columns * rows};
+    }
+    case PrimitiveType::UV_SPHERE:
+    {
+        const uint32_t segments = getCount(p[0], 3), rings = getCount(p[1], 2);
+        return {segments * (rings - 1) + 2, 6 * segments * (rings - 1)};
+    }
+    default:
+        return {};
+    }
+}
+
+bool write(const PrimitiveDesc& desc, PrimitiveVertex* vertices, uint32_t* indices)
+{
+    using namespace internal;
+    const std::array<float, 4>& p = desc.parameters;
+    switch(desc.type)
+    {
+    case PrimitiveType::CYLINDER:
+    {
+        const uint32_t segments = getCount(p[0], 3);
+        const float radius = p[1], halfHeight = 0.5f * p[2];
+        const std::vector<glm::vec2> directions = getRingDirections(segments, 0.0f);
+        *vertices++ = {glm::vec3(0.0f, halfHeight, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)};
+        vertices = writeRing(vertices, directions, {radius, halfHeight, 0.0f, 1.0f});
+        vertices = writeRing(vertices, directions, {radius, halfHeight, 1.0f, 0.0f});
+        vertices = writeRing(vertices, directions, {radius, -halfHeight, 1.0f, 0.0f});
+        vertices = writeRing(vertices, directions, {radius, -halfHeight, 0.0f, -1.0f});
+        *vertices = {glm::vec3(0.0f, -halfHeight, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)};
+
+        indices = writeFan(indices, 0, 1, segments, true);
+        indices = writeBand(indices, 1 + segments, 1 + 2 * segments, segments);
+        writeFan(indices, 1 + 4 * segments, 1 + 3 * segments, segments, false);
+        return true;
+    }
+    case PrimitiveType::CONE:
+    {
+        const uint32_t segments = getCount(p[0], 3);
+        const float radius = p[1], halfHeight = 0.5f * p[2];
+        // Perpendicular to the slope from the base to the apex
+        const float slope = std::sqrt(radius * radius + 4.0f * halfHeight * halfHeight);
+        const float normalRadial = slope > 0.0f ? 2.0f * halfHeight / slope : 0.0f;
+        const float normalY = slope > 0.0f ? radius / slope : 1.0f;
+        const std::vector<glm::vec2> directions = getRingDirections(segments, 0.0f);
+        vertices = writeRing(vertices, getRingDirections(segments, 0.5f), {0.0f, halfHeight, normalRadial, normalY});
+        vertices = writeRing(vertices, directions, {radius, -halfHeight, normalRadial, normalY});
+        vertices = writeRing(vertices, directions, {radius, -halfHeight, 0.0f, -1.0f});
+        *vertices = {glm::vec3(0.0f, -halfHeight, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)};
+
+        for(uint32_t i = 0; i < segments; i++)
+        {
+            const uint32_t j = i + 1 < segments ? i + 1 : 0;
+            const uint32_t side[3] = {i, segments + j, segments + i};
+            indices = std::copy(side, side + 3, indices);
+        }
+        writeFan(indices, 3 * segments, 2 * segments, segments, false);
+        return true;
+    }
+    case PrimitiveType::TORUS:
+    {
+        const uint32_t majorSegments = getCount(p[0], 3), minorSegments = getCount(p[1], 3);
+        const float majorRadius = p[2], minorRadius = p[3];
+        const std::vector<glm::vec2> majorDirections = getRingDirections(majorSegments, 0.0f);
+        const std::vector<glm::vec2> minorDirections = getRingDirections(minorSegments, 0.0f);
+        // Tube rings around the major circle, each one from the outer equator going up
+        for(const glm::vec2& major : majorDirections)
+        {
+            for(const glm::vec2& minor : minorDirections)
+            {
+                const glm::vec3 normal(minor.x * major.x, minor.y, minor.x * major.y);
+                *vertices++ = {glm::vec3(majorRadius * major.x, 0.0f, majorRadius * major.y) + minorRadius * normal, normal};
+            }
+        }
+
+        for(uint32_t i = 0; i < majorSegments; i++)
+        {
+            const uint32_t ring = i * minorSegments, nextRing = (i + 1 < majorSegments ? i + 1 : 0) * minorSegments;
+            for(uint32_t j = 0; j < minorSegments; j++)
+            {
+                const uint32_t k = j + 1 < minorSegments ? j + 1 : 0;
+                const uint32_t quad[6] = {ring + j, ring + k, nextRing + k, ring + j, nextRing + k, nextRing + j};
+                indices = std::copy(quad, quad + 6, indices);
+            }
+        }
+        return true;
+    }
+    case PrimitiveType::CAPSULE:
+    {
+        const uint32_t segments = getCount(p[0], 3), rings = getCount(p[1], 1);
+        const float radius = p[2], halfHeight = 0.5f * p[3];
+        // The equators of both hemispheres share their normals, so the cylinder between them is smooth
+        std::vector<LatheRing> lathe(2 * rings);
+        for(uint32_t r = 0; r < rings; r++)
+        {
+            const float angle = 0.5f * PRIMITIVES_PI * static_cast<float>(r + 1) / static_cast<float>(rings);
+            const float sin = std::sin(angle), cos = std::cos(angle);
+            lathe[r] = {radius * sin, halfHeight + radius * cos, sin, cos};
+            lathe[2 * rings - 1 - r] = {radius * sin, -halfHeight - radius * cos, sin, -cos};
+        }
+        writeLathe(vertices, indices, segments, halfHeight + radius, -halfHeight - radius, lathe);
+        return true;
+    }
+    case PrimitiveType::GRID:
+    {
+        const uint32_t columns = getCount(p[0], 1), rows = getCount(p[1], 1);
+        for(uint32_t y = 0; y <= rows; y++)
+        {
+            for(uint32_t x = 0; x <= columns; x++)
+            {
+                const glm::vec3 position(static_cast<float>(x) / static_cast<float>(columns) - 0.5f,
+                                         static_cast<float>(y) / static_cast<float>(rows) - 0.5f, 0.0f);
+                *vertices++ = {position, glm::vec3(0.0f, 0.0f, 1.0f)};
+            }
+        }
+
+        // Same diagonal as the plane
+        for(uint32_t y = 0; y < rows; y++)
+        {
+            for(uint32_t x = 0; x < columns; x++)
+            {
+                const uint32_t v00 = y * (columns + 1) + x, v10 = v00 + 1, v01 = v00 + columns + 1, v11 = v01 + 1;
+                const uint32_t quad[6] = {v00, v10, v11, v11, v01, v00};
+                indices = std::copy(quad, quad + 6, indices);
+            }
+        }
+        return true;
+    }
+    case PrimitiveType::UV_SPHERE:
+    {
+        const uint32_t segments = getCount(p[0], 3), rings = getCount(p[1], 2);
+        const float radius = p[2];
+        std::vector<LatheRing> lathe(rings - 1);
+        for(uint32_t r = 0; r + 1 < rings; r++)
+        {
+            const float angle = PRIMITIVES_PI * static_cast<float>(r + 1) / static_cast<float>(rings);
+            const float sin = std::sin(angle), cos = std::cos(angle);
+            lathe[r] = {radius * sin, radius * cos, sin, cos};
+        }
+        writeLathe(vertices, indices, segments, radius, -radius, lathe);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+BoundingBox getBoundingBox(const PrimitiveDesc& desc)
+{
+    const std::array<float, 4>& p = desc.parameters;
+    glm::vec3 halfSize(0.5f);
+    switch(desc.type)
+    {
+    case PrimitiveType::ISOSPHERE:
+        halfSize = glm::vec3(1.0f);
+        break;
+    case PrimitiveType::PLANE:
+    case PrimitiveType::GRID:
+        halfSize = glm::vec3(0.5f, 0.5f, 0.0f);
+        break;
+    case PrimitiveType::CUBE:
+        break;
+    case PrimitiveType::CYLINDER:
+    case PrimitiveType::CONE:
+        halfSize = glm::vec3(p[1], 0.5f * p[2], p[1]);
+        break;
+    case PrimitiveType::TORUS:
+        halfSize = glm::vec3(p[2] + p[3], p[3], p[2] + p[3]);
+        break;
+    case PrimitiveType::CAPSULE:
+        halfSize = glm::vec3(p[2], 0.5f * p[3] + p[2], p[2]);
+        break;
+    case PrimitiveType::UV_SPHERE:
+        halfSize = glm::vec3(p[2]);
+        break;
+    }
+    return BoundingBox(-halfSize, halfSize);
+}
+
 }
 
 }
\ No newline at end of file
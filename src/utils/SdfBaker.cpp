@@ -0,0 +1,323 @@
+#include "MyRender/utils/SdfBaker.h"
+#include "MyRender/utils/MappedFile.h"
+#include "MyRender/utils/Parallel.h"
+#include "utils/SdfSampling.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace myrender
+{
+
+namespace internal
+{
+    constexpr float SDF_PI = 3.14159265358979f;
+    // Nodes further than this times their radius are approximated by a dipole
+    constexpr float SDF_WINDING_ACCURACY = 2.0f;
+    constexpr uint32_t SDF_STACK_SIZE = 96;
+
+    // Signed solid angle of a triangle divided by 4 pi, positive when the point is behind it (Van Oosterom and Strackee)
+    inline float getTriangleWinding(const glm::vec3& p, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+    {
+        const glm::vec3 a = v0 - p;
+        const glm::vec3 b = v1 - p;
+        const glm::vec3 c = v2 - p;
+        const float la = glm::length(a);
+        const float lb = glm::length(b);
+        const float lc = glm::length(c);
+        const float det = glm::dot(a, glm::cross(b, c));
+        const float div = la * lb * lc + glm::dot(a, b) * lc + glm::dot(b, c) * la + glm::dot(c, a) * lb;
+        return std::atan2(det, div) / (2.0f * SDF_PI);
+    }
+
+    WindingNumber::WindingNumber(const MeshBVH& bvh)
+        : mBvh(bvh)
+    {
+        const std::vector<MeshBVH::Node>& nodes = bvh.getNodes();
+        const std::vector<uint32_t>& triangles = bvh.getTriangles();
+        const std::vector<glm::vec3>& vertices = bvh.getMesh()->getVertices();
+        const std::vector<uint32_t>& indices = bvh.getMesh()->getIndices();
+        mDipoles.resize(nodes.size());
+
+        // The traversal holds at most one pending sibling per level plus the two children of the deepest node
+        std::vector<uint32_t> depths(nodes.size(), 0);
+        uint32_t maxDepth = 0;
+        for(size_t n = 0; n < nodes.size(); n++)
+        {
+            maxDepth = std::max(maxDepth, depths[n]);
+            if(nodes[n].isLeaf()) continue;
+            depths[nodes[n].firstChildOrTriangle] = depths[nodes[n].firstChildOrTriangle + 1] = depths[n] + 1;
+        }
+        mStackSize = maxDepth + 2;
+
+        // Children are always after their parents
+        for(size_t n = nodes.size(); n-- > 0;)
+        {
+            const MeshBVH::Node& node = nodes[n];
+            WindingDipole& dipole = mDipoles[n];
+            glm::vec3 weightedCenter(0.0f);
+            dipole.areaVector = glm::vec3(0.0f);
+            dipole.area = 0.0f;
+            if(node.isLeaf())
+            {
+                for(uint32_t i = node.firstChildOrTriangle; i < node.firstChildOrTriangle + node.numTriangles; i++)
+                {
+                    const uint32_t t = triangles[i];
+                    const glm::vec3& v0 = vertices[indices[3 * t]];
+                    const glm::vec3& v1 = vertices[indices[3 * t + 1]];
+                    const glm::vec3& v2 = vertices[indices[3 * t + 2]];
+                    const glm::vec3 areaVector = 0.5f * glm::cross(v1 - v0, v2 - v0);
+                    const float area = glm::length(areaVector);
+                    weightedCenter += area * (v0 + v1 + v2) / 3.0f;
+                    dipole.areaVector += areaVector;
+                    dipole.area += area;
+                }
+            }
+            else
+            {
+                for(uint32_t child = node.firstChildOrTriangle; child < node.firstChildOrTriangle + 2; child++)
+                {
+                    weightedCenter += mDipoles[child].area * mDipoles[child].center;
+                    dipole.areaVector += mDipoles[child].areaVector;
+                    dipole.area += mDipoles[child].area;
+                }
+            }
+
+            const glm::vec3 boxCenter = 0.5f * (node.min + node.max);
+            dipole.center = dipole.area > 0.0f ? weightedCenter / dipole.area : boxCenter;
+            dipole.radius = glm::length(glm::max(dipole.center - node.min, node.max - dipole.center));
+        }
+    }
+
+    float WindingNumber::get(const glm::vec3& p) const
+    {
+        const std::vector<MeshBVH::Node>& nodes = mBvh.getNodes();
+        if(nodes.empty()) return 0.0f;
+        const std::vector<uint32_t>& triangles = mBvh.getTriangles();
+        const std::vector<glm::vec3>& vertices = mBvh.getMesh()->getVertices();
+        const std::vector<uint32_t>& indices = mBvh.getMesh()->getIndices();
+
+        float winding = 0.0f;
+        // Balanced trees fit in the fixed stack, the vector only covers degenerate deep ones
+        uint32_t fixedStack[SDF_STACK_SIZE];
+        std::vector<uint32_t> heapStack;
+        uint32_t* stack = fixedStack;
+        if(mStackSize > SDF_STACK_SIZE)
+        {
+            heapStack.resize(mStackSize);
+            stack = heapStack.data();
+        }
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while(stackSize > 0)
+        {
+            const uint32_t n = stack[--stackSize];
+            const MeshBVH::Node& node = nodes[n];
+            const WindingDipole& dipole = mDipoles[n];
+
+            const glm::vec3 toCenter = dipole.center - p;
+            const float distance = glm::length(toCenter);
+            if(distance > SDF_WINDING_ACCURACY * dipole.radius)
+            {
+                winding += glm::dot(dipole.areaVector, toCenter) / (4.0f * SDF_PI * distance * distance * distance);
+            }
+            else if(node.isLeaf())
+            {
+                for(uint32_t i = node.firstChildOrTriangle; i < node.firstChildOrTriangle + node.numTriangles; i++)
+                {
+                    const uint32_t t = triangles[i];
+                    winding += getTriangleWinding(p, vertices[indices[3 * t]], vertices[indices[3 * t + 1]],
+                                                  vertices[indices[3 * t + 2]]);
+                }
+            }
+            else
+            {
+                stack[stackSize++] = node.firstChildOrTriangle;
+                stack[stackSize++] = node.firstChildOrTriangle + 1;
+            }
+        }
+        return winding;
+    }
+
+    float getDistance(const MeshBVH& bvh, const glm::vec3& p, NearestPoint& nearest, bool usePrevious)
+    {
+        const float maxDistance = usePrevious ? 1.0001f * glm::length(nearest.point - p) + 1e-6f : FLT_MAX;
+        if(!bvh.findNearestPoint(p, nearest, maxDistance)) bvh.findNearestPoint(p, nearest);
+        return nearest.distance;
+    }
+
+    // Marks the samples of a row along x that are inside the mesh by counting the signed crossings of a ray
+    void getRowInside(const MeshBVH& bvh, const glm::vec3& rowOrigin, float voxelSize, uint32_t numSamples,
+                      std::vector<RayHit>& hits, std::vector<uint8_t>& inside)
+    {
+        const std::vector<glm::vec3>& vertices = bvh.getMesh()->getVertices();
+        const std::vector<uint32_t>& indices = bvh.getMesh()->getIndices();
+        const glm::vec3 direction(1.0f, 0.0f, 0.0f);
+
+        // The ray starts one voxel before the row, the grid margin keeps it outside the mesh
+        Ray ray(rowOrigin - voxelSize * direction, direction, voxelSize * static_cast<float>(numSamples + 1));
+        hits.clear();
+        bvh.intersectAll(ray, hits);
+
+        // A ray through a shared edge or vertex hits every triangle around it. Those hits crossing the
+        // surface the same way count once, and the ones entering and leaving at the same point cancel
+        const float epsilon = 1e-5f * voxelSize;
+        inside.assign(numSamples, 0);
+        int32_t crossings = 0;
+        size_t h = 0;
+        for(uint32_t x = 0; x < numSamples; x++)
+        {
+            const float t = voxelSize * static_cast<float>(x + 1);
+            while(h < hits.size() && hits[h].t < t)
+            {
+                int32_t entering = 0, leaving = 0;
+                const float groupStart = hits[h].t;
+                for(; h < hits.size() && hits[h].t - groupStart <= epsilon; h++)
+                {
+                    const uint32_t triangle = hits[h].triangle;
+                    const glm::vec3& v0 = vertices[indices[3 * triangle]];
+                    const glm::vec3 normal = glm::cross(vertices[indices[3 * triangle + 1]] - v0, vertices[indices[3 * triangle + 2]] - v0);
+                    if(normal.x < 0.0f) entering = 1;
+                    else leaving = 1;
+                }
+                crossings += entering - leaving;
+            }
+            inside[x] = crossings > 0;
+        }
+    }
+}
+
+float SdfGrid::sample(const glm::vec3& point) const
+{
+    if(values.empty()) return 0.0f;
+    const glm::vec3 maxCoord = glm::vec3(resolution - glm::uvec3(1));
+    const glm::vec3 coord = glm::clamp((point - origin) / voxelSize, glm::vec3(0.0f), maxCoord);
+    const glm::uvec3 c0 = glm::min(glm::uvec3(coord), glm::max(resolution, glm::uvec3(2)) - glm::uvec3(2));
+    const glm::uvec3 c1 = glm::min(c0 + glm::uvec3(1), resolution - glm::uvec3(1));
+    const glm::vec3 f = coord - glm::vec3(c0);
+
+    const float v00 = glm::mix(getValue(c0.x, c0.y, c0.z), getValue(c1.x, c0.y, c0.z), f.x);
+    const float v10 = glm::mix(getValue(c0.x, c1.y, c0.z), getValue(c1.x, c1.y, c0.z), f.x);
+    const float v01 = glm::mix(getValue(c0.x, c0.y, c1.z), getValue(c1.x, c0.y, c1.z), f.x);
+    const float v11 = glm::mix(getValue(c0.x, c1.y, c1.z), getValue(c1.x, c1.y, c1.z), f.x);
+    return glm::mix(glm::mix(v00, v10, f.y), glm::mix(v01, v11, f.y), f.z);
+}
+
+SdfGrid SdfBaker::bake(const Mesh& mesh, uint32_t resolution, float marginRatio, SignMethod signMethod, uint32_t numThreads)
+{
+    SdfGrid grid;
+    if(mesh.getIndices().empty() || resolution < 2) return grid;
+
+    // The root bounds of the BVH, which do not depend on the mesh box being up to date
+    MeshBVH bvh(mesh, numThreads);
+    BoundingBox box = bvh.getBoundingBox();
+    const glm::vec3 size = box.getSize();
+    const float maxSize = std::max(size.x, std::max(size.y, size.z));
+    box.addMargin(marginRatio * maxSize);
+    const glm::vec3 boxSize = box.getSize();
+    grid.voxelSize = std::max(boxSize.x, std::max(boxSize.y, boxSize.z)) / static_cast<float>(resolution - 1);
+    grid.resolution = glm::max(glm::uvec3(glm::ceil(boxSize / grid.voxelSize - 1e-3f)) + glm::uvec3(1), glm::uvec3(2));
+    // Centered, the axes shorter than the largest one may span a bit more than the box
+    grid.origin = box.getCenter() - 0.5f * grid.voxelSize * glm::vec3(grid.resolution - glm::uvec3(1));
+    grid.values.resize(static_cast<size_t>(grid.resolution.x) * grid.resolution.y * grid.resolution.z);
+
+    std::unique_ptr<internal::WindingNumber> winding;
+    if(signMethod == SignMethod::WINDING_NUMBER) winding.reset(new internal::WindingNumber(bvh));
+
+    Parallel::forRange(0, grid.resolution.z, [&](size_t zBegin, size_t zEnd, uint32_t)
+    {
+        std::vector<RayHit> hits;
+        std::vector<uint8_t> inside;
+        for(uint32_t z = static_cast<uint32_t>(zBegin); z < zEnd; z++)
+        {
+            for(uint32_t y = 0; y < grid.resolution.y; y++)
+            {
+                if(signMethod == SignMethod::RAY_PARITY)
+                {
+                    internal::getRowInside(bvh, grid.getPosition(0, y, z), grid.voxelSize, grid.resolution.x, hits, inside);
+                }
+
+                NearestPoint nearest;
+                for(uint32_t x = 0; x < grid.resolution.x; x++)
+                {
+                    const glm::vec3 p = grid.getPosition(x, y, z);
+                    const float distance = internal::getDistance(bvh, p, nearest, x > 0);
+                    const bool isInside = signMethod == SignMethod::RAY_PARITY ? inside[x] != 0 : winding->get(p) > 0.5f;
+                    grid.values[grid.getIndex(x, y, z)] = isInside ? -distance : distance;
+                }
+            }
+        }
+    }, numThreads, 1);
+
+    return grid;
+}
+
+bool SdfBaker::write(const std::string& path, const SdfGrid& grid)
+{
+    Header header = {MAGIC, VERSION, {grid.resolution.x, grid.resolution.y, grid.resolution.z},
+                     {grid.origin.x, grid.origin.y, grid.origin.z}, grid.voxelSize, 0, 0};
+    header.dataOffset = (sizeof(Header) + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        std::cout << "Error: the file " << path << " could not be opened for writing" << std::endl;
+        return false;
+    }
+
+    const char padding[DATA_ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(padding, header.dataOffset - sizeof(Header));
+    file.write(reinterpret_cast<const char*>(grid.values.data()), grid.values.size() * sizeof(float));
+
+    if(!file.good())
+    {
+        std::cout << "Error: the file " << path << " could not be written" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SdfBaker::read(const std::string& path, SdfGrid& grid)
+{
+    MappedFile file;
+    if(!file.open(path))
+    {
+        std::cout << "Error: the file " << path << " could not be mapped" << std::endl;
+        return false;
+    }
+
+    auto fail = [&](const char* reason)
+    {
+        std::cout << "Error: " << path << " is not a valid sdf file, " << reason << std::endl;
+        return false;
+    };
+
+    if(file.getSize() < sizeof(Header)) return fail("it is too small");
+    Header header;
+    std::memcpy(&header, file.getData(), sizeof(Header));
+    if(header.magic != MAGIC) return fail("wrong magic number");
+    if(header.version > VERSION) return fail("unsupported version");
+    if(header.resolution[0] == 0 || header.resolution[1] == 0 || header.resolution[2] == 0) return fail("zero resolution");
+    if(!(header.voxelSize > 0.0f) || !std::isfinite(header.voxelSize)) return fail("invalid voxel size");
+    if(header.dataOffset < sizeof(Header) || header.dataOffset % DATA_ALIGNMENT != 0) return fail("invalid data offset");
+    if(header.dataOffset > file.getSize()) return fail("it is truncated");
+
+    // Written with divisions, so crafted resolutions cannot wrap around
+    const uint64_t maxValues = (file.getSize() - header.dataOffset) / sizeof(float);
+    const uint64_t sliceValues = static_cast<uint64_t>(header.resolution[0]) * header.resolution[1];
+    if(sliceValues > maxValues || header.resolution[2] > maxValues / sliceValues) return fail("it is truncated");
+    const uint64_t numValues = sliceValues * header.resolution[2];
+
+    grid.resolution = glm::uvec3(header.resolution[0], header.resolution[1], header.resolution[2]);
+    grid.origin = glm::vec3(header.origin[0], header.origin[1], header.origin[2]);
+    grid.voxelSize = header.voxelSize;
+    grid.values.resize(numValues);
+    std::memcpy(grid.values.data(), file.getData() + header.dataOffset, numValues * sizeof(float));
+    return true;
+}
+
+}
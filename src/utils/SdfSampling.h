@@ -0,0 +1,45 @@
+#ifndef SDF_SAMPLING_H
+#define SDF_SAMPLING_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "MyRender/utils/MeshBVH.h"
+
+namespace myrender
+{
+
+namespace internal
+{
+    // First order approximation of the winding number of the triangles of a BVH node seen from far away
+    struct WindingDipole
+    {
+        glm::vec3 center;     // Area weighted centroid
+        float radius;         // Of a sphere around center that holds the node
+        glm::vec3 areaVector; // Sum of the triangle normals scaled by their areas
+        float area;
+    };
+
+    // Generalized winding number of the mesh of a BVH, which has to outlive it. Far nodes are approximated
+    // by dipoles and near triangles use their exact solid angle
+    class WindingNumber
+    {
+    public:
+        WindingNumber(const MeshBVH& bvh);
+
+        // About 1 inside a closed mesh with the triangles in counter clockwise order seen from outside, 0 outside
+        float get(const glm::vec3& p) const;
+
+    private:
+        const MeshBVH& mBvh;
+        std::vector<WindingDipole> mDipoles;
+        uint32_t mStackSize = 0; // Entries the traversal can need, from the depth of the tree
+    };
+
+    // Distance to the mesh of the BVH. With usePrevious the nearest point of the previous query, usually a close
+    // sample, bounds the search, which prunes most of it
+    float getDistance(const MeshBVH& bvh, const glm::vec3& p, NearestPoint& nearest, bool usePrevious);
+}
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "MyRender/utils/Simd.h"
+
+#include <atomic>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace myrender
+{
+
+namespace Simd
+{
+
+namespace internal
+{
+    Level detectLevel()
+    {
+        // SSE2 is part of the x86-64 baseline, only AVX2 needs to be queried
+#if defined(_MSC_VER) && defined(_M_X64)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+
+        bool avx2 = false;
+        if(maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+        return avx2 ? Level::AVX2 : Level::SSE;
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) return Level::AVX2;
+        return Level::SSE;
+#else
+        return Level::SCALAR;
+#endif
+    }
+
+    std::atomic<Level>& currentLevel()
+    {
+        static std::atomic<Level> level(getSupportedLevel());
+        return level;
+    }
+}
+
+Level getSupportedLevel()
+{
+    static const Level level = internal::detectLevel();
+    return level;
+}
+
+Level getLevel()
+{
+    return internal::currentLevel().load(std::memory_order_relaxed);
+}
+
+void setLevel(Level level)
+{
+    if(static_cast<int>(level) > static_cast<int>(getSupportedLevel()))
+    {
+        level = getSupportedLevel();
+    }
+    internal::currentLevel().store(level, std::memory_order_relaxed);
+}
+
+const char* getLevelName(Level level)
+{
+    switch(level)
+    {
+        case Level::SCALAR: return "Scalar";
+        case Level::SSE: return "SSE2";
+        case Level::AVX2: return "AVX2";
+    }
+    return "Unknown";
+}
+
+}
+
+}
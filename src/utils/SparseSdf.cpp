@@ -0,0 +1,298 @@
+#include "MyRender/utils/SparseSdf.h"
+#include "MyRender/utils/MappedFile.h"
+#include "MyRender/utils/Parallel.h"
+#include "MyRender/shaders/Shader.h"
+#include "utils/SdfSampling.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace myrender
+{
+
+namespace internal
+{
+    constexpr uint32_t SPARSE_SDF_HEADER_WORDS = sizeof(SparseSdf::GpuHeader) / sizeof(uint32_t);
+    static_assert(SparseSdf::BRICK_SAMPLES % 2 == 0, "Brick samples are packed in pairs");
+
+    inline float trilinear(const float* c, const glm::vec3& f)
+    {
+        const float v00 = glm::mix(c[0], c[1], f.x);
+        const float v10 = glm::mix(c[2], c[3], f.x);
+        const float v01 = glm::mix(c[4], c[5], f.x);
+        const float v11 = glm::mix(c[6], c[7], f.x);
+        return glm::mix(glm::mix(v00, v10, f.y), glm::mix(v01, v11, f.y), f.z);
+    }
+}
+
+void SparseSdf::build(const Mesh& mesh, uint32_t resolution, float marginRatio, uint32_t numThreads)
+{
+    *this = SparseSdf();
+    if(mesh.getIndices().empty() || resolution < 2) return;
+
+    const MeshBVH bvh(mesh, numThreads);
+    const internal::WindingNumber winding(bvh);
+
+    BoundingBox box = bvh.getBoundingBox();
+    const glm::vec3 size = box.getSize();
+    box.addMargin(marginRatio * std::max(size.x, std::max(size.y, size.z)));
+    const glm::vec3 boxSize = box.getSize();
+    mVoxelSize = std::max(boxSize.x, std::max(boxSize.y, boxSize.z)) / static_cast<float>(resolution - 1);
+    const float cellSize = static_cast<float>(BRICK_SIZE - 1) * mVoxelSize;
+    mNumCells = glm::max(glm::uvec3(glm::ceil(boxSize / cellSize - 1e-3f)), glm::uvec3(1));
+    mOrigin = box.getCenter() - 0.5f * cellSize * glm::vec3(mNumCells);
+
+    // The samples of a brick are at most half a cell diagonal from its center
+    const float halfDiagonal = 0.5f * std::sqrt(3.0f) * cellSize;
+    mBrickRange = 2.0f * halfDiagonal + 2.0f * mVoxelSize;
+
+    // Coarse corners everywhere
+    const glm::uvec3 numCorners = mNumCells + glm::uvec3(1);
+    mCoarseValues.resize(static_cast<size_t>(numCorners.x) * numCorners.y * numCorners.z);
+    Parallel::forRange(0, numCorners.z, [&](size_t zBegin, size_t zEnd, uint32_t)
+    {
+        for(uint32_t z = static_cast<uint32_t>(zBegin); z < zEnd; z++)
+        {
+            for(uint32_t y = 0; y < numCorners.y; y++)
+            {
+                NearestPoint nearest;
+                for(uint32_t x = 0; x < numCorners.x; x++)
+                {
+                    const glm::vec3 p = mOrigin + cellSize * glm::vec3(x, y, z);
+                    const float distance = internal::getDistance(bvh, p, nearest, x > 0);
+                    mCoarseValues[(static_cast<size_t>(z) * numCorners.y + y) * numCorners.x + x] = winding.get(p) > 0.5f ? -distance : distance;
+                }
+            }
+        }
+    }, numThreads, 1);
+
+    // A cell can only hold surface if its center is closer than half its diagonal. One more voxel of
+    // margin keeps the interpolation near the surface inside the bricks
+    mBrickIndices.assign(static_cast<size_t>(mNumCells.x) * mNumCells.y * mNumCells.z, NO_BRICK);
+    std::vector<uint8_t> refine(mBrickIndices.size(), 0);
+    Parallel::forRange(0, mNumCells.z, [&](size_t zBegin, size_t zEnd, uint32_t)
+    {
+        for(uint32_t z = static_cast<uint32_t>(zBegin); z < zEnd; z++)
+        {
+            for(uint32_t y = 0; y < mNumCells.y; y++)
+            {
+                NearestPoint nearest;
+                for(uint32_t x = 0; x < mNumCells.x; x++)
+                {
+                    const glm::vec3 center = mOrigin + cellSize * (glm::vec3(x, y, z) + glm::vec3(0.5f));
+                    const float distance = internal::getDistance(bvh, center, nearest, x > 0);
+                    refine[getCellIndex(glm::uvec3(x, y, z))] = distance <= halfDiagonal + mVoxelSize;
+                }
+            }
+        }
+    }, numThreads, 1);
+
+    std::vector<uint32_t> brickCells;
+    for(size_t c = 0; c < refine.size(); c++)
+    {
+        if(!refine[c]) continue;
+        mBrickIndices[c] = static_cast<uint32_t>(brickCells.size());
+        brickCells.push_back(static_cast<uint32_t>(c));
+    }
+
+    mBrickData.resize(brickCells.size() * BRICK_SAMPLES);
+    Parallel::forRange(0, brickCells.size(), [&](size_t begin, size_t end, uint32_t)
+    {
+        for(size_t b = begin; b < end; b++)
+        {
+            const uint32_t c = brickCells[b];
+            const glm::uvec3 cell(c % mNumCells.x, (c / mNumCells.x) % mNumCells.y, c / (mNumCells.x * mNumCells.y));
+            const glm::vec3 cellOrigin = mOrigin + cellSize * glm::vec3(cell);
+            uint16_t* brick = mBrickData.data() + b * BRICK_SAMPLES;
+            for(uint32_t z = 0; z < BRICK_SIZE; z++)
+            {
+                for(uint32_t y = 0; y < BRICK_SIZE; y++)
+                {
+                    NearestPoint nearest;
+                    for(uint32_t x = 0; x < BRICK_SIZE; x++)
+                    {
+                        const glm::vec3 p = cellOrigin + mVoxelSize * glm::vec3(x, y, z);
+                        const float distance = internal::getDistance(bvh, p, nearest, x > 0);
+                        brick[(z * BRICK_SIZE + y) * BRICK_SIZE + x] = encode(winding.get(p) > 0.5f ? -distance : distance);
+                    }
+                }
+            }
+        }
+    }, numThreads, 1);
+}
+
+uint16_t SparseSdf::encode(float distance) const
+{
+    const float value = (distance / mBrickRange + 1.0f) * 32767.5f;
+    return static_cast<uint16_t>(glm::clamp(value + 0.5f, 0.0f, 65535.0f));
+}
+
+float SparseSdf::sample(const glm::vec3& point) const
+{
+    if(mCoarseValues.empty()) return 0.0f;
+    const float cellSize = static_cast<float>(BRICK_SIZE - 1) * mVoxelSize;
+    const glm::vec3 coord = glm::clamp((point - mOrigin) / cellSize, glm::vec3(0.0f), glm::vec3(mNumCells));
+    const glm::uvec3 cell = glm::min(glm::uvec3(coord), mNumCells - glm::uvec3(1));
+    const glm::vec3 local = coord - glm::vec3(cell);
+
+    float corners[8];
+    const uint32_t brickIndex = mBrickIndices[getCellIndex(cell)];
+    if(brickIndex == NO_BRICK)
+    {
+        for(uint32_t i = 0; i < 8; i++)
+        {
+            corners[i] = getCoarseValue(cell.x + (i & 1), cell.y + ((i >> 1) & 1), cell.z + (i >> 2));
+        }
+        return internal::trilinear(corners, local);
+    }
+
+    const glm::vec3 brickCoord = static_cast<float>(BRICK_SIZE - 1) * local;
+    const glm::uvec3 s = glm::min(glm::uvec3(brickCoord), glm::uvec3(BRICK_SIZE - 2));
+    const uint16_t* brick = mBrickData.data() + static_cast<size_t>(brickIndex) * BRICK_SAMPLES;
+    for(uint32_t i = 0; i < 8; i++)
+    {
+        corners[i] = decode(brick[((s.z + (i >> 2)) * BRICK_SIZE + s.y + ((i >> 1) & 1)) * BRICK_SIZE + s.x + (i & 1)]);
+    }
+    return internal::trilinear(corners, brickCoord - glm::vec3(s));
+}
+
+size_t SparseSdf::getMemorySize() const
+{
+    return mCoarseValues.size() * sizeof(float) + mBrickIndices.size() * sizeof(uint32_t) + mBrickData.size() * sizeof(uint16_t);
+}
+
+void SparseSdf::getGpuData(std::vector<uint32_t>& data) const
+{
+    GpuHeader header = {{mNumCells.x, mNumCells.y, mNumCells.z}, getNumBricks(), {mOrigin.x, mOrigin.y, mOrigin.z},
+                        mVoxelSize, mBrickRange, 0, 0, 0};
+    header.coarseValuesOffset = internal::SPARSE_SDF_HEADER_WORDS;
+    header.brickIndicesOffset = header.coarseValuesOffset + static_cast<uint32_t>(mCoarseValues.size());
+    header.brickDataOffset = header.brickIndicesOffset + static_cast<uint32_t>(mBrickIndices.size());
+
+    data.resize(header.brickDataOffset + mBrickData.size() / 2);
+    std::memcpy(data.data(), &header, sizeof(GpuHeader));
+    std::memcpy(data.data() + header.coarseValuesOffset, mCoarseValues.data(), mCoarseValues.size() * sizeof(float));
+    std::memcpy(data.data() + header.brickIndicesOffset, mBrickIndices.data(), mBrickIndices.size() * sizeof(uint32_t));
+    for(size_t i = 0; i < mBrickData.size(); i += 2)
+    {
+        data[header.brickDataOffset + i / 2] = static_cast<uint32_t>(mBrickData[i]) | (static_cast<uint32_t>(mBrickData[i + 1]) << 16);
+    }
+}
+
+bool SparseSdf::setGpuData(const uint32_t* data, size_t numWords)
+{
+    if(numWords < internal::SPARSE_SDF_HEADER_WORDS) return false;
+    GpuHeader header;
+    std::memcpy(&header, data, sizeof(GpuHeader));
+    if(!(header.voxelSize > 0.0f) || !std::isfinite(header.voxelSize)) return false;
+    if(!(header.brickRange > 0.0f) || !std::isfinite(header.brickRange)) return false;
+
+    // Sizes and ranges written with divisions and subtractions, so crafted headers cannot wrap around
+    auto getCount = [&](uint64_t x, uint64_t y, uint64_t z, uint64_t& count)
+    {
+        if(x == 0 || y == 0 || z == 0 || x > numWords || y > numWords / x || z > numWords / (x * y)) return false;
+        count = x * y * z;
+        return true;
+    };
+    auto fits = [&](uint64_t offset, uint64_t count) { return offset <= numWords && count <= numWords - offset; };
+    uint64_t numCells, numCorners;
+    if(!getCount(header.numCells[0], header.numCells[1], header.numCells[2], numCells) ||
+       !getCount(header.numCells[0] + 1ull, header.numCells[1] + 1ull, header.numCells[2] + 1ull, numCorners))
+    {
+        return false;
+    }
+    const uint64_t numBrickWords = static_cast<uint64_t>(header.numBricks) * BRICK_SAMPLES / 2;
+    if(!fits(header.coarseValuesOffset, numCorners) || !fits(header.brickIndicesOffset, numCells) ||
+       !fits(header.brickDataOffset, numBrickWords))
+    {
+        return false;
+    }
+
+    mNumCells = glm::uvec3(header.numCells[0], header.numCells[1], header.numCells[2]);
+    mOrigin = glm::vec3(header.origin[0], header.origin[1], header.origin[2]);
+    mVoxelSize = header.voxelSize;
+    mBrickRange = header.brickRange;
+    mCoarseValues.resize(numCorners);
+    std::memcpy(mCoarseValues.data(), data + header.coarseValuesOffset, numCorners * sizeof(float));
+    mBrickIndices.assign(data + header.brickIndicesOffset, data + header.brickIndicesOffset + numCells);
+    for(uint32_t index : mBrickIndices)
+    {
+        if(index != NO_BRICK && index >= header.numBricks) return false;
+    }
+    mBrickData.resize(2 * numBrickWords);
+    for(size_t i = 0; i < numBrickWords; i++)
+    {
+        const uint32_t word = data[header.brickDataOffset + i];
+        mBrickData[2 * i] = static_cast<uint16_t>(word & 0xffff);
+        mBrickData[2 * i + 1] = static_cast<uint16_t>(word >> 16);
+    }
+    return true;
+}
+
+bool SparseSdf::upload(Shader& shader, const std::string& bufferName) const
+{
+    std::vector<uint32_t> data;
+    getGpuData(data);
+    return shader.setBufferData(bufferName, data.data(), data.size() * sizeof(uint32_t));
+}
+
+bool SparseSdf::write(const std::string& path) const
+{
+    std::vector<uint32_t> data;
+    getGpuData(data);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        std::cout << "Error: the file " << path << " could not be opened for writing" << std::endl;
+        return false;
+    }
+
+    const uint32_t header[2] = {MAGIC, VERSION};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(uint32_t));
+
+    if(!file.good())
+    {
+        std::cout << "Error: the file " << path << " could not be written" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SparseSdf::read(const std::string& path)
+{
+    MappedFile file;
+    if(!file.open(path))
+    {
+        std::cout << "Error: the file " << path << " could not be mapped" << std::endl;
+        return false;
+    }
+
+    uint32_t header[2];
+    if(file.getSize() < sizeof(header) || (file.getSize() - sizeof(header)) % sizeof(uint32_t) != 0)
+    {
+        std::cout << "Error: " << path << " is not a valid sparse sdf file, wrong size" << std::endl;
+        return false;
+    }
+    std::memcpy(header, file.getData(), sizeof(header));
+    if(header[0] != MAGIC || header[1] > VERSION)
+    {
+        std::cout << "Error: " << path << " is not a valid sparse sdf file, wrong magic number or version" << std::endl;
+        return false;
+    }
+
+    // The mapping is page aligned, so the words after the 8 bytes header are aligned too
+    const uint32_t* data = reinterpret_cast<const uint32_t*>(file.getData() + sizeof(header));
+    if(!setGpuData(data, (file.getSize() - sizeof(header)) / sizeof(uint32_t)))
+    {
+        *this = SparseSdf();
+        std::cout << "Error: " << path << " is not a valid sparse sdf file, it is truncated or corrupted" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}